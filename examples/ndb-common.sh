@@ -2,16 +2,20 @@
 
 # Source this script from your shell or script to access these common shortcut functions
 
+# cndb starts much faster than qndb, as it doesn't load Qt. Set NDB_CLI to
+# use another client.
+NDB_CLI="${NDB_CLI:-$(command -v cndb || echo qndb)}"
+
 ndb_input_dlg()
 {
     input_title="$1"
     [ -z "$input_title" ] && printf "Usage: ndb_input_dlg TITLE\n" && return 1
-    qndb -m dlgConfirmCreate true
-    qndb -m dlgConfirmSetTitle "$input_title"
-    qndb -m dlgConfirmSetAccept "Ok"
-    qndb -m dlgConfirmSetReject "Cancel"
-    qndb -m dlgConfirmSetModal true
-    qndb -s dlgConfirmTextInput -m dlgConfirmShow
+    "$NDB_CLI" -m dlgConfirmCreate true
+    "$NDB_CLI" -m dlgConfirmSetTitle "$input_title"
+    "$NDB_CLI" -m dlgConfirmSetAccept "Ok"
+    "$NDB_CLI" -m dlgConfirmSetReject "Cancel"
+    "$NDB_CLI" -m dlgConfirmSetModal true
+    "$NDB_CLI" -s dlgConfirmTextInput -m dlgConfirmShow
     return
 }
 
@@ -19,13 +23,13 @@ ndb_pw_dlg()
 {
     pw_title="$1"
     [ -z "$pw_title" ] && printf "Usage: ndb_pw_dlg TITLE\n" && return 1
-    qndb -m dlgConfirmCreate true
-    qndb -m dlgConfirmSetTitle "$pw_title"
-    qndb -m dlgConfirmSetAccept "Ok"
-    qndb -m dlgConfirmSetReject "Cancel"
-    qndb -m dlgConfirmSetModal true
-    qndb -m dlgConfirmSetLEPassword true
-    qndb -s dlgConfirmTextInput -m dlgConfirmShow
+    "$NDB_CLI" -m dlgConfirmCreate true
+    "$NDB_CLI" -m dlgConfirmSetTitle "$pw_title"
+    "$NDB_CLI" -m dlgConfirmSetAccept "Ok"
+    "$NDB_CLI" -m dlgConfirmSetReject "Cancel"
+    "$NDB_CLI" -m dlgConfirmSetModal true
+    "$NDB_CLI" -m dlgConfirmSetLEPassword true
+    "$NDB_CLI" -s dlgConfirmTextInput -m dlgConfirmShow
     return
 }
 
@@ -34,12 +38,12 @@ ndb_modal_dlg()
     modal_title="$1"
     modal_body="$2"
     [ -z "$modal_title" ] || [ -z "$modal_body" ]  && printf "Usage: ndb_modal_dlg TITLE BODY\n" && return 1
-    qndb -m dlgConfirmCreate
-    qndb -m dlgConfirmSetTitle "$modal_title"
-    qndb -m dlgConfirmSetBody "$modal_body"
-    qndb -m dlgConfirmSetModal true
-    qndb -m dlgConfirmShowClose false
-    qndb -m dlgConfirmShow
+    "$NDB_CLI" -m dlgConfirmCreate
+    "$NDB_CLI" -m dlgConfirmSetTitle "$modal_title"
+    "$NDB_CLI" -m dlgConfirmSetBody "$modal_body"
+    "$NDB_CLI" -m dlgConfirmSetModal true
+    "$NDB_CLI" -m dlgConfirmShowClose false
+    "$NDB_CLI" -m dlgConfirmShow
     return
 }
 
@@ -47,18 +51,18 @@ ndb_update_modal_dlg()
 {
     modal_update="$1"
     [ -z "$modal_update" ]  && printf "Usage: ndb_update_modal_dlg BODY\n" && return 1
-    qndb -m dlgConfirmSetBody "$modal_update"
+    "$NDB_CLI" -m dlgConfirmSetBody "$modal_update"
     return
 }
 
 ndb_close_dlg()
 {
-    qndb -m dlgConfirmClose
+    "$NDB_CLI" -m dlgConfirmClose
     return
 }
 
 ndb_reboot()
 {
-    qndb -m pwrReboot
+    "$NDB_CLI" -m pwrReboot
     return
 }
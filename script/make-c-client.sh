@@ -0,0 +1,147 @@
+#!/bin/sh
+
+# Generate the typed functions and method table of the C client in src/cndb
+# from the D-Bus interface description. Methods whose arguments are all basic
+# types get a function each, named after the method, taking the method
+# arguments followed by pointers for the return values. Where a method has
+# several argument counts, the longest keeps the plain name, and the others
+# get their argument count appended. The method table is sorted by name (in
+# the C locale), then by argument count, so that it can be binary searched.
+
+xml_file=$1
+out_dir=$2
+tab=$(printf '\t')
+xml_name=$(basename "$xml_file")
+
+# Typed functions, declared (mode=h) or defined (mode=c)
+gen_funcs='
+BEGIN {
+    split("i u x t d b s o h", types, " ")
+    split("int32_t uint32_t int64_t uint64_t double int char* char* -", ctypes, " ")
+    split("dbus_int32_t dbus_uint32_t dbus_int64_t dbus_uint64_t double dbus_bool_t char* char* int", ltypes, " ")
+    split("INT32 UINT32 INT64 UINT64 DOUBLE BOOLEAN STRING OBJECT_PATH UNIX_FD", dtypes, " ")
+    for (i = 1; i <= 9; i++) {
+        ctype[types[i]] = ctypes[i] == "char*" ? "const char *" : ctypes[i] " "
+        otype[types[i]] = ctypes[i] == "char*" ? "char **" : (ctypes[i] == "-" ? "int" : ctypes[i]) " *"
+        ltype[types[i]] = ltypes[i] == "char*" ? "const char *" : ltypes[i] " "
+        dtype[types[i]] = "DBUS_TYPE_" dtypes[i]
+    }
+}
+{ line[NR] = $0; if (!($1 in maxc) || $2 > maxc[$1]) { maxc[$1] = $2 } }
+END { for (i = 1; i <= NR; i++) { gen(line[i]) } }
+function gen(l,    f, n, k, p, name, supported, proto, outs, call, get, locals, copy) {
+    n = split(l, f, "\t")
+    name = f[1]
+    supported = 1
+    proto = "int ndb_" name (f[2] < maxc[name] ? "_" f[2] : "") "(ndb_conn *ndb"
+    call = "    DBusMessage *reply = ndb_call(ndb, \"" name "\""
+    get = "    int r = ndb_reply_args(ndb, reply"
+    outs = ""
+    locals = ""
+    copy = ""
+    for (k = 4; k <= n; k++) {
+        split(f[k], p, " ")
+        if (!(p[1] in dtype) || (p[3] == "in" && p[1] == "h")) {
+            supported = 0
+        } else if (p[3] == "in") {
+            proto = proto ", " ctype[p[1]] p[2]
+            if (p[1] == "b") {
+                locals = locals "    dbus_bool_t " p[2] "_b = " p[2] ";\n"
+                call = call ", " dtype[p[1]] ", &" p[2] "_b"
+            } else {
+                call = call ", " dtype[p[1]] ", &" p[2]
+            }
+        } else {
+            outs = outs ", " otype[p[1]] p[2]
+            locals = locals "    " ltype[p[1]] p[2] "_r;\n"
+            get = get ", " dtype[p[1]] ", &" p[2] "_r"
+            if (p[1] == "s" || p[1] == "o") {
+                copy = copy "        if (" p[2] ") { *" p[2] " = strdup(" p[2] "_r); }\n"
+            } else if (p[1] == "h") {
+                copy = copy "        if (" p[2] ") { *" p[2] " = " p[2] "_r; } else { close(" p[2] "_r); }\n"
+            } else {
+                copy = copy "        if (" p[2] ") { *" p[2] " = " p[2] "_r; }\n"
+            }
+        }
+    }
+    proto = proto outs ")"
+    if (mode == "h") {
+        if (supported) {
+            print proto ";"
+        } else {
+            print "// " name " (" f[2] " arguments) uses container types, call it with ndb_call_strings()"
+        }
+    } else if (supported) {
+        printf "\n%s {\n%s%s, DBUS_TYPE_INVALID);\n%s, DBUS_TYPE_INVALID);\n", proto, locals, call, get
+        if (copy != "") {
+            printf "    if (r == 0) {\n%s    }\n", copy
+        }
+        printf "    ndb_reply_free(reply);\n    return r;\n}\n"
+    }
+}
+'
+
+# One line per method: name, argument count, in signature, then the type and
+# name of each argument, as in:out
+methods=$(awk '
+function attr(line, key) {
+    if (match(line, key "=\"[^\"]*\"")) {
+        return substr(line, RSTART + length(key) + 2, RLENGTH - length(key) - 3)
+    }
+    return ""
+}
+/<method name=/ { name = attr($0, "name"); inm = 1; n = 0; ins = ""; args = ""; next }
+inm && /<arg / {
+    t = attr($0, "type")
+    a = attr($0, "name")
+    if (attr($0, "direction") == "in") {
+        ins = ins t
+        n++
+        args = args "\t" t " " a " in"
+    } else {
+        args = args "\t" t " " (a == "" ? "ret" : a) " out"
+    }
+}
+inm && /<\/method>/ { printf "%s\t%d\t%s%s\n", name, n, ins, args; inm = 0 }
+' "$xml_file" | LC_ALL=C sort -t "$tab" -k1,1 -k2,2n)
+
+{
+cat <<EOF
+// Generated by script/make-c-client.sh from $xml_name. Do not edit.
+#ifndef NDB_METHODS_H
+#define NDB_METHODS_H
+
+struct ndb_method {
+    const char *name;
+    int argc;
+    const char *in_sig;
+};
+
+extern const struct ndb_method ndb_methods[];
+extern const int ndb_method_count;
+
+EOF
+printf '%s\n' "$methods" | awk -F "$tab" -v mode=h "$gen_funcs"
+cat <<EOF
+
+#endif // NDB_METHODS_H
+EOF
+} > "$out_dir/ndb_methods.h"
+
+{
+cat <<EOF
+// Generated by script/make-c-client.sh from $xml_name. Do not edit.
+#include <string.h>
+#include <unistd.h>
+#include "ndb_client.h"
+
+const struct ndb_method ndb_methods[] = {
+EOF
+printf '%s\n' "$methods" | awk -F "$tab" '{ printf "    {\"%s\", %d, \"%s\"},\n", $1, $2, $3 }'
+cat <<EOF
+};
+
+const int ndb_method_count = sizeof(ndb_methods) / sizeof(ndb_methods[0]);
+EOF
+printf '%s\n' "$methods" | awk -F "$tab" -v mode=c "$gen_funcs"
+} > "$out_dir/ndb_methods.c"
@@ -0,0 +1,50 @@
+#!/bin/sh
+
+# Generate the table qndb uses to look up and call methods, from the D-Bus
+# interface description. Entries are sorted by name (in the C locale), then
+# by argument count, so that qndb can binary search them.
+
+xml_file=$1
+out_file=$2
+tab=$(printf '\t')
+
+{
+cat <<EOF
+// Generated by script/make-cli-dispatch.sh from $(basename "$xml_file"). Do not edit.
+#ifndef NDB_DISPATCH_H
+#define NDB_DISPATCH_H
+
+struct NDBDispatchEntry {
+    const char *name;
+    int argc;
+    const char *args[10]; // D-Bus signature of each argument
+    const char *outSig;
+};
+
+static const NDBDispatchEntry ndbDispatchTable[] = {
+EOF
+awk '
+function attr(line, key,    m) {
+    if (match(line, key "=\"[^\"]*\"")) {
+        m = substr(line, RSTART + length(key) + 2, RLENGTH - length(key) - 3)
+        return m
+    }
+    return ""
+}
+/<method name=/ { name = attr($0, "name"); inm = 1; n = 0; ins = ""; outs = ""; next }
+inm && /<arg / {
+    if (attr($0, "direction") == "in") {
+        ins = ins (n ? ", " : "") "\"" attr($0, "type") "\""
+        n++
+    } else {
+        outs = outs attr($0, "type")
+    }
+}
+inm && /<\/method>/ { printf "%s\t%d\t%s\t%s\n", name, n, ins, outs; inm = 0 }
+' "$xml_file" | LC_ALL=C sort -t "$tab" -k1,1 -k2,2n | awk -F "$tab" '{ printf "    {\"%s\", %s, {%s}, \"%s\"},\n", $1, $2, $3, $4 }'
+cat <<EOF
+};
+
+#endif // NDB_DISPATCH_H
+EOF
+} > "$out_file"
@@ -0,0 +1,48 @@
+#!/bin/sh
+
+# Measure how long the NickelDBus command line clients take from start to
+# exit, on a device with NickelDBus running. Each client is run the given
+# number of times with the same arguments, and the mean time per run is
+# printed in milliseconds. hyperfine is used if it is installed, otherwise
+# the runs are timed with /proc/uptime, which has a 10 ms resolution, so use
+# enough runs for the total to be well above that.
+#
+# Usage: ndb-cli-bench.sh [-n runs] [client...] [-- args...]
+# Defaults to 20 runs of qndb and cndb, calling ndbVersion.
+
+runs=20
+clients=
+while [ $# -gt 0 ]; do
+    case $1 in
+        -n) runs=$2; shift 2 ;;
+        --) shift; break ;;
+        *) clients="$clients $1"; shift ;;
+    esac
+done
+[ -n "$clients" ] || clients="qndb cndb"
+[ $# -gt 0 ] || set -- -m ndbVersion
+
+# Centiseconds since boot
+uptime_cs() {
+    read -r up _ < /proc/uptime
+    echo "${up%.*}${up#*.}"
+}
+
+for client in $clients; do
+    if ! "$client" "$@" > /dev/null; then
+        echo "$client $* failed" >&2
+        exit 1
+    fi
+    if command -v hyperfine > /dev/null; then
+        hyperfine -N --warmup 3 --runs "$runs" "$client $*"
+        continue
+    fi
+    start=$(uptime_cs)
+    i=0
+    while [ $i -lt "$runs" ]; do
+        "$client" "$@" > /dev/null
+        i=$((i + 1))
+    done
+    end=$(uptime_cs)
+    echo "$client: $(( (end - start) * 10 / runs )) ms per run ($runs runs)"
+done
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Decode a NickelDBus flight recorder file.
+
+Copy /tmp/nickeldbus-flight off the device, then run:
+
+    script/ndb-flightlog.py nickeldbus-flight
+
+Records are printed oldest first, one per line. See src/ndb/NDBFlightRecorder.h
+for the file format.
+"""
+import argparse
+import datetime
+import struct
+import sys
+
+HEADER = struct.Struct('<8sIIQQI28x')
+RECORD = struct.Struct('<HBBIqIBBH')
+MAGIC = b'NDBFLT\0\0'
+VERSION = 1
+
+TYPES = {0: 'pad', 1: 'start', 2: 'call', 3: 'error', 4: 'signal', 5: 'view', 6: 'usbms'}
+
+
+def records(buf):
+    magic, version, capacity, head, tail, _ = HEADER.unpack_from(buf, 0)
+    if magic != MAGIC:
+        raise SystemExit('not a NickelDBus flight recorder file')
+    if version != VERSION:
+        raise SystemExit('unsupported flight recorder version %d' % version)
+    data = buf[HEADER.size:HEADER.size + capacity]
+    pos = tail
+    while pos < head:
+        off = pos % capacity
+        size = struct.unpack_from('<H', data, off)[0]
+        if size == 0 or size % 4:
+            raise SystemExit('corrupt record at offset %d' % off)
+        if data[off + 2] != 0:
+            _, typ, flags, seq, time, duration, len_a, len_b, _ = RECORD.unpack_from(data, off)
+            a = data[off + RECORD.size:off + RECORD.size + len_a].decode('utf-8', 'replace')
+            b = data[off + RECORD.size + len_a:off + RECORD.size + len_a + len_b].decode('utf-8', 'replace')
+            yield seq, time, typ, flags, duration, a, b
+        pos += size
+
+
+def describe(typ, flags, duration, a, b):
+    if typ == 2:
+        return '%s from %s in %dms%s' % (a, b or '(internal)', duration, ', reply delayed' if flags & 1 else '')
+    if typ == 3:
+        return '%s: %s' % (a, b)
+    if typ == 6:
+        return 'session started' if flags & 1 else 'session ended'
+    return ' '.join(s for s in (a, b) if s)
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    p.add_argument('file', help='flight recorder file')
+    p.add_argument('-t', '--type', action='append', choices=sorted(set(TYPES.values()) - {'pad'}),
+                   help='only print records of this type (may be repeated)')
+    args = p.parse_args()
+    with open(args.file, 'rb') as f:
+        buf = f.read()
+    out = sys.stdout
+    for seq, time, typ, flags, duration, a, b in records(buf):
+        name = TYPES.get(typ, 'type%d' % typ)
+        if args.type and name not in args.type:
+            continue
+        ts = datetime.datetime.fromtimestamp(time / 1000.0).strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]
+        out.write('%8d %s %-6s %s\n' % (seq, ts, name, describe(typ, flags, duration, a, b)))
+
+
+main()
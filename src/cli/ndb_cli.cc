@@ -5,219 +5,360 @@
 #include <QTextStream>
 #include <QDebug>
 #include <QTimer>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
-#include <type_traits>
+#include <algorithm>
+#include <climits>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "ndb_cli.h"
+#include "ndb_dispatch.h"
+#include "ndb_marshal.h"
 
-MethodParamList::MethodParamList() {
-    mp.resize(10);
-}
-
-MethodParamList::~MethodParamList() {
-    for (int i = 0; i < mp.size(); ++i) {
-        if (mp[i].param) {
-            QMetaType::destroy(mp[i].type, mp[i].param);
-        }
-    }
-}
-
-NDBCli::NDBCli(QObject* parent, com::github::shermp::nickeldbus *ndb) : QObject(parent) {
-    this->ndb = ndb;
+NDBCli::NDBCli(QObject* parent, QDBusConnection const& conn, QString const& service) : QObject(parent), conn(conn), service(service) {
     signalComplete = methodComplete = false;
+    follow = json = batch = false;
+    batchNext = batchFailed = 0;
+    followCount = followed = 0;
     methodName = QString();
     methodArgs = QStringList();
     signalNames = QStringList();
     timeout = -1;
 }
 
-int NDBCli::getMethodIndex() {
-    const QMetaObject *mo = ndb->metaObject();
-    for (int i = mo->methodOffset(); i < mo->methodCount(); ++i ) {
-        QMetaMethod method = mo->method(i);
-        if (!QString(method.name()).compare(methodName) && (method.methodType() == QMetaMethod::Method || method.methodType() == QMetaMethod::Slot)) {
-            if (method.parameterCount() == methodArgs.size()) {
-                return i;
-            }
-        }
-    }
-    return -1;
+// Calls qndb makes for itself, rather than the one asked for. These go out
+// as plain messages, since a proxy would check that NickelDBus is running
+// when it is created, which costs another round trip.
+QDBusMessage NDBCli::callInternal(QString const& method, QVariantList const& args) {
+    QDBusMessage msg = QDBusMessage::createMethodCall(service, "/nickeldbus", NDBProxy::staticInterfaceName(), method);
+    msg.setArguments(args);
+    return conn.call(msg);
 }
 
-bool NDBCli::convertParam(int index, int typeID, void *param) {
-    bool ok = false;
-
-    if (typeID == QMetaType::Type::Int) {
-        int *i = reinterpret_cast<int*> (param);
-        *i = methodArgs.at(index).toInt(&ok); 
-
-    } else if (typeID == QMetaType::Type::Bool) {
-        bool *b = reinterpret_cast<bool*> (param);
-        ok = true;
-        if (!methodArgs.at(index).compare("true", Qt::CaseInsensitive) || !methodArgs.at(index).compare("t", Qt::CaseInsensitive)) {
-            *b = true;
-        } else if (!methodArgs.at(index).compare("false", Qt::CaseInsensitive) || !methodArgs.at(index).compare("f", Qt::CaseInsensitive)) {
-            *b = false;
-        } else {
-            ok = false;
-        }
-
-    } else if (typeID == QMetaType::Type::QString) {
-        QString *s = reinterpret_cast<QString*> (param);
-        s->append(methodArgs.at(index));
-        ok = true;
+static bool dispatchLess(NDBDispatchEntry const& e, QPair<QByteArray, int> const& key) {
+    int c = strcmp(e.name, key.first.constData());
+    return c < 0 || (c == 0 && e.argc < key.second);
+}
 
-    } else {
-        ok = false;
+// Binary search the generated table for the method, by name and argument count
+const NDBDispatchEntry* NDBCli::findMethod(QString const& name, int argc) {
+    QPair<QByteArray, int> key(name.toLatin1(), argc);
+    const NDBDispatchEntry *end = ndbDispatchTable + sizeof(ndbDispatchTable) / sizeof(ndbDispatchTable[0]);
+    const NDBDispatchEntry *e = std::lower_bound(ndbDispatchTable, end, key, dispatchLess);
+    if (e == end || strcmp(e->name, key.first.constData()) || e->argc != key.second) {
+        return nullptr;
     }
-    return ok;
+    return e;
 }
 
-template<typename T>
-int NDBCli::printMethodReply(void *reply) {
-    int rv = -1;
-    QDBusPendingReply<T> *r = reinterpret_cast<QDBusPendingReply<T>*>(reply);
-    r->waitForFinished();
-    if (!r->isError()) {
-        if (r->count() > 0) {
-            QTextStream(stdout) << r->value() << endl;
+// Print each argument of the reply on its own line, in order. String lists get
+// one line per item, and maps one line per key. Other containers are printed
+// as JSON. With --json, the whole reply is printed as a JSON array instead.
+int NDBCli::printReply(QDBusMessage const& reply) {
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        QDBusError err(reply);
+        errString = QString("method failed with err: %1 and message: %2").arg(QDBusError::errorString(err.type())).arg(err.message());
+        return -1;
+    }
+    QTextStream out(stdout);
+    if (json) {
+        QJsonArray args;
+        for (QVariant const& arg : reply.arguments()) {
+            if (arg.userType() == qMetaTypeId<QDBusUnixFileDescriptor>()) {
+                return pipeReply(arg.value<QDBusUnixFileDescriptor>());
+            }
+            args.append(ndbArgToJson(arg));
+        }
+        out << QJsonDocument(args).toJson(QJsonDocument::Compact) << endl;
+        return 0;
+    }
+    for (QVariant const& arg : reply.arguments()) {
+        if (arg.userType() == qMetaTypeId<QDBusUnixFileDescriptor>()) {
+            return pipeReply(arg.value<QDBusUnixFileDescriptor>());
+        } else if (arg.type() == QVariant::Bool) {
+            out << (arg.toBool() ? 1 : 0) << endl;
+        } else if (arg.type() == QVariant::StringList) {
+            for (QString const& item : arg.toStringList()) {
+                out << item << endl;
+            }
+        } else if (arg.userType() == qMetaTypeId<QDBusArgument>() && qvariant_cast<QDBusArgument>(arg).currentSignature() == "av") {
+            // Journal events are printed one per line, as 'seq time name args...'
+            for (QVariant const& item : qdbus_cast<QVariantList>(arg)) {
+                QVariantMap ev = qdbus_cast<QVariantMap>(item);
+                out << ev.value("seq").toString() << " " << ev.value("time").toString() << " " << ev.value("name").toString();
+                for (QVariant const& a : qdbus_cast<QVariantList>(ev.value("args"))) {
+                    out << " " << a.toString();
+                }
+                out << endl;
+            }
+        } else if (arg.userType() == qMetaTypeId<QDBusArgument>() && qvariant_cast<QDBusArgument>(arg).currentSignature() == "a{sv}") {
+            // Maps are printed as one 'key value' pair per line, with list
+            // values separated by spaces
+            QVariantMap map = qdbus_cast<QVariantMap>(arg);
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                QVariant val = it.value();
+                out << it.key() << " " << (val.type() == QVariant::StringList ? val.toStringList().join(" ") : val.toString()) << endl;
+            }
+        } else {
+            QJsonValue val = ndbArgToJson(arg);
+            if (val.isArray()) {
+                out << QJsonDocument(val.toArray()).toJson(QJsonDocument::Compact) << endl;
+            } else if (val.isObject()) {
+                out << QJsonDocument(val.toObject()).toJson(QJsonDocument::Compact) << endl;
+            } else if (val.isString()) {
+                out << val.toString() << endl;
+            } else {
+                out << arg.toString() << endl;
+            }
         }
-        rv = 0;
-    } else {
-        errString = QString("method failed with err: %1 and message: %2").arg(QDBusError::errorString(r->error().type())).arg(r->error().message());
     }
-    return rv;
+    return 0;
 }
 
-// We seem to need to make this a separate function from above, as the compiler
-// throws a fit when typename parameter is void.
-int NDBCli::printMethodReply(void *reply) {
-    int rv = -0;
-    QDBusPendingReply<> *r = reinterpret_cast<QDBusPendingReply<>*>(reply);
-    r->waitForFinished();
-    if (r->isError()) {
-        errString = QString("method failed with err: %1 and message: %2").arg(QDBusError::errorString(r->error().type())).arg(r->error().message());
-        rv = -1;
+// Methods returning a file descriptor hand out a pipe. Copy our stdin to it
+// until EOF, so that shell scripts can simply redirect into qndb.
+int NDBCli::pipeReply(QDBusUnixFileDescriptor const& fd) {
+    if (!fd.isValid()) {
+        errString = QStringLiteral("method did not return a valid file descriptor");
+        return -1;
+    }
+    // Report a closed dialog as an error instead of dying silently
+    signal(SIGPIPE, SIG_IGN);
+    char buf[512];
+    ssize_t n;
+    while ((n = read(STDIN_FILENO, buf, sizeof(buf))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            errString = QString("error reading stdin: %1").arg(strerror(errno));
+            return -1;
+        }
+        for (ssize_t off = 0; off < n;) {
+            ssize_t w = write(fd.fileDescriptor(), buf + off, n - off);
+            if (w < 0) {
+                if (errno == EINTR) { continue; }
+                errString = QString("error writing to pipe: %1").arg(strerror(errno));
+                return -1;
+            }
+            off += w;
+        }
     }
-    return rv;
+    return 0;
 }
 
-int NDBCli::callMethodInvoke() {
-    int methodIndex = getMethodIndex();
-    if (methodIndex < 0) {
+// Build the call from the generated dispatch table
+bool NDBCli::buildCall(QString const& name, QStringList const& args, QDBusMessage& msg) {
+    const NDBDispatchEntry *e = findMethod(name, args.size());
+    if (!e) {
         errString = QStringLiteral("non-existent method or invalid parameter count");
-        return -1;
-    }
-    QMetaMethod m = ndb->metaObject()->method(methodIndex);
-    if (m.parameterCount() > 10) {
-        errString = QStringLiteral("a maximum of 10 parameters are allowed");
-        return -1;
+        return false;
     }
-    MethodParamList params = MethodParamList();
-    for (int i = 0; i < m.parameterCount(); ++i) {
-        params.mp[i].type = m.parameterType(i);
-        params.mp[i].param = QMetaType::create(params.mp[i].type);
-        if (!convertParam(i, params.mp[i].type, params.mp[i].param)) {
-            errString = QString("unable to convert parameter %1").arg(QString(m.parameterNames().at(i)));
-            return -1;
+    QList<QVariant> callArgs;
+    for (int i = 0; i < e->argc; ++i) {
+        QVariant arg;
+        if (!ndbArgFromString(e->args[i], args.at(i), arg)) {
+            errString = QString("unable to convert parameter %1 to type '%2'").arg(i + 1).arg(e->args[i]);
+            return false;
         }
-        params.mp[i].genericArg = QGenericArgument(m.parameterNames().at(i), params.mp[i].param);
+        callArgs.append(arg);
     }
-    // QDBusPendingReply<> doesn't appear to be a QObject, and even if it is, it
-    // isn't registered as a QMetaType. We'll take care of it here, and register
-    // one of every type we may currently encounter (plus int, because it could
-    // be used in the future).
-    int voidPR = qRegisterMetaType<QDBusPendingReply<>>("QDBusPendingReply<>");
-    int strPR = qRegisterMetaType<QDBusPendingReply<QString>>("QDBusPendingReply<QString>");
-    int boolPR = qRegisterMetaType<QDBusPendingReply<bool>>("QDBusPendingReply<bool>");
-    int intPR = qRegisterMetaType<QDBusPendingReply<int>>("QDBusPendingReply<int>");
-    int id = QMetaType::type(m.typeName());
-    if (id == QMetaType::UnknownType) {
-        errString = QStringLiteral("could not create variable of unknown type");
+    msg = QDBusMessage::createMethodCall(service, "/nickeldbus", NDBProxy::staticInterfaceName(), e->name);
+    msg.setArguments(callArgs);
+    return true;
+}
+
+int NDBCli::callMethod() {
+    QDBusMessage msg;
+    if (!buildCall(methodName, methodArgs, msg)) {
         return -1;
     }
-    void *ret = QMetaType::create(id);
-    if (!ret) {
-        errString = QStringLiteral("unable to create return variable");
-        return -1;
+    // Some methods only reply once the user has responded to a dialog,
+    // so don't let the default D-Bus reply timeout cut them short.
+    return printReply(conn.call(msg, QDBus::Block, timeout > 0 ? timeout : INT_MAX));
+}
+
+// Arguments in a batch are converted the same way as on the command line, so
+// strings are used as is, and anything else is passed on as JSON
+static QString jsonArgString(QJsonValue const& v) {
+    if (v.isString()) {
+        return v.toString();
     }
-    if (!m.invoke(ndb, 
-        Qt::DirectConnection, 
-        QGenericReturnArgument(m.typeName(), ret), 
-        params.mp[0].genericArg, params.mp[1].genericArg, params.mp[2].genericArg, params.mp[3].genericArg, params.mp[4].genericArg,
-        params.mp[5].genericArg, params.mp[6].genericArg, params.mp[7].genericArg, params.mp[8].genericArg, params.mp[9].genericArg
-    )) {
-        errString = QString("unable to call method %1").arg(QString(m.methodSignature()));
-        QMetaType::destroy(id, ret);
-        return -1;
+    QJsonArray wrapped;
+    wrapped.append(v);
+    QByteArray json = QJsonDocument(wrapped).toJson(QJsonDocument::Compact);
+    return QString::fromUtf8(json.mid(1, json.size() - 2));
+}
+
+// In batch mode, calls are read from stdin, one per line, as a JSON array of
+// the method name followed by its arguments. Each call is sent as soon as it
+// is read, without waiting for the previous reply, so that a batch of
+// independent calls costs about one round trip instead of one per call.
+// Replies are printed in the same order as the calls.
+void NDBCli::runBatch() {
+    QTextStream in(stdin);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        QJsonArray call = QJsonDocument::fromJson(line.toUtf8()).array();
+        QString name = call.isEmpty() ? QString() : call.at(0).toString();
+        QStringList args;
+        for (int i = 1; i < call.size(); ++i) {
+            args.append(jsonArgString(call.at(i)));
+        }
+        QDBusMessage msg;
+        if (name.isEmpty()) {
+            errString = QStringLiteral("a call must be a JSON array of the method name and its arguments");
+            batchCalls.append(QDBusPendingCall::fromError(QDBusError(QDBusError::InvalidArgs, errString)));
+        } else if (!buildCall(name, args, msg)) {
+            batchCalls.append(QDBusPendingCall::fromError(QDBusError(QDBusError::InvalidArgs, errString)));
+        } else {
+            batchCalls.append(conn.asyncCall(msg, timeout > 0 ? timeout : INT_MAX));
+        }
+        batchMethods.append(name);
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(batchCalls.last(), this);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, this, &NDBCli::batchCallFinished);
     }
-    // Stupid templated class. Is there a way of making the following more generic?
-    int printRV;
-    if      (id == voidPR) {printRV = printMethodReply(ret);}
-    else if (id == strPR)  {printRV = printMethodReply<QString>(ret);}
-    else if (id == boolPR) {printRV = printMethodReply<bool>(ret);}
-    else if (id == intPR)  {printRV = printMethodReply<int>(ret);}
-    else {printRV = -1;}
-    QMetaType::destroy(id, ret);
-    return printRV;
+    printBatch();
+}
+
+void NDBCli::batchCallFinished(QDBusPendingCallWatcher* watcher) {
+    watcher->deleteLater();
+    printBatch();
 }
 
-#define NDBCLI_SIG_NAME() QString(sender()->metaObject()->method(senderSignalIndex()).name())
-#define NDBCLI_SIG_CONNECT(signal, handler) QObject::connect(ndb, &NDBProxy::signal, this, &NDBCli::handler)
-
-void NDBCli::connectSignals() {
-    NDBCLI_SIG_CONNECT(dlgConfirmResult, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(dlgConfirmTextInput, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(pfmAboutToConnect, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(pfmDoneProcessing, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(fssFinished, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(fssGotNumFilesToProcess, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(fssParseProgress, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(wmLinkQualityForConnectedNetwork, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(wmMacAddressAvailable, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(wmNetworkConnected, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmNetworkDisconnected, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmNetworkFailedToConnect, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmNetworkForgotten, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmScanningAborted, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmScanningFinished, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmScanningStarted, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmTryingToConnect, handleSignalParam0);
-    NDBCLI_SIG_CONNECT(wmWifiEnabled, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(ndbViewChanged, handleSignalParam1);
-    NDBCLI_SIG_CONNECT(rvPageChanged, handleSignalParam1);
+// Print the replies that are in, up to the first call still waiting for one.
+// Each is printed as a JSON object on its own line, with either the reply
+// arguments or the error.
+void NDBCli::printBatch() {
+    QTextStream out(stdout);
+    for (; batchNext < batchCalls.size() && batchCalls.at(batchNext).isFinished(); ++batchNext) {
+        QDBusPendingCall const& call = batchCalls.at(batchNext);
+        QJsonObject obj;
+        obj.insert("method", batchMethods.at(batchNext));
+        if (call.isError()) {
+            obj.insert("error", call.error().name());
+            obj.insert("message", call.error().message());
+            ++batchFailed;
+        } else {
+            QJsonArray reply;
+            for (QVariant const& arg : call.reply().arguments()) {
+                reply.append(ndbArgToJson(arg));
+            }
+            obj.insert("reply", reply);
+        }
+        out << QJsonDocument(obj).toJson(QJsonDocument::Compact) << endl;
+    }
+    if (batchNext == batchCalls.size()) {
+        QCoreApplication::exit(batchFailed > 0 ? 1 : 0);
+    }
 }
 
-void NDBCli::handleSignalParam0() {
-    handleSignal(NDBCLI_SIG_NAME());
+static bool hasSignal(QString const& name) {
+    const QMetaObject *mo = &NDBProxy::staticMetaObject;
+    for (int i = mo->methodOffset(); i < mo->methodCount(); ++i) {
+        QMetaMethod method = mo->method(i);
+        if (method.methodType() == QMetaMethod::Signal && method.name() == name.toLatin1()) {
+            return true;
+        }
+    }
+    return false;
 }
 
-void NDBCli::handleSignalParam1(QVariant val1) {
-    handleSignal(NDBCLI_SIG_NAME(), val1);
+// Only the signals asked for are subscribed to, each with its own match rule,
+// so that qndb isn't woken up by the others. Following every signal needs a
+// single rule for the whole interface.
+bool NDBCli::connectSignals() {
+    QStringList names = signalNames;
+    if (names.isEmpty()) {
+        names.append(QString());
+    }
+    for (QString const& name : names) {
+        if (!name.isEmpty() && !hasSignal(name)) {
+            errString = QString("non-existent signal %1").arg(name);
+            return false;
+        }
+        if (!conn.connect(service, "/nickeldbus", NDBProxy::staticInterfaceName(), name, this, SLOT(handleDBusSignal(QDBusMessage)))) {
+            errString = QString("unable to subscribe to %1: %2").arg(name.isEmpty() ? QStringLiteral("signals") : name).arg(conn.lastError().message());
+            return false;
+        }
+    }
+    return true;
 }
 
-void NDBCli::handleSignalParam2(QVariant val1, QVariant val2) {
-    handleSignal(NDBCLI_SIG_NAME(), val1, val2);
+void NDBCli::handleDBusSignal(QDBusMessage const& msg) {
+    handleSignal(msg.member(), msg.arguments());
 }
 
-void NDBCli::handleSignal(const QString& sigName, QVariant val1, QVariant val2, QVariant val3, QVariant val4) {
-    if (signalNames.contains(sigName)) {
+void NDBCli::handleSignal(const QString& sigName, QVariantList const& args) {
+    if (follow) {
+        if (signalNames.isEmpty() || signalNames.contains(sigName)) {
+            followSignal(sigName, args);
+        }
+        return;
+    }
+    // A signal found in the journal by replayEvents() also arrives live
+    if (signalNames.contains(sigName) && !signalComplete) {
+        signalComplete = true;
         QTextStream out(stdout);
         out << sigName;
-        if (val1.isValid()) { out << " " << val1.toString(); }
-        if (val2.isValid()) { out << " " << val2.toString(); }
-        if (val3.isValid()) { out << " " << val3.toString(); }
-        if (val4.isValid()) { out << " " << val4.toString(); }
+        for (QVariant const& arg : args) {
+            out << " " << arg.toString();
+        }
         out << endl;
         if (methodName.isEmpty() || methodComplete) {
+            QCoreApplication::quit();
+        }
+    }
+}
+
+// In follow mode, each signal is printed as a JSON object on its own line,
+// and flushed straight away so that it can be piped into another program.
+void NDBCli::followSignal(const QString& sigName, QVariantList const& args) {
+    QJsonObject obj;
+    obj.insert("name", sigName);
+    QJsonArray jsonArgs;
+    for (QVariant const& arg : args) {
+        jsonArgs.append(ndbArgToJson(arg));
+    }
+    obj.insert("args", jsonArgs);
+    obj.insert("time", QDateTime::currentMSecsSinceEpoch());
+    QTextStream(stdout) << QJsonDocument(obj).toJson(QJsonDocument::Compact) << endl;
+    if (followCount > 0 && ++followed >= followCount) {
         QCoreApplication::quit();
-        } else {
-            signalComplete = true;
+    }
+}
+
+// The subscription is active before the method is called, so signals caused
+// by the call are delivered live too, but only once the event loop gets to
+// them. Looking in the journal finds them straight after the reply.
+void NDBCli::replayEvents(qulonglong seq) {
+    QDBusMessage r = callInternal("ndbEventsSince", QVariantList() << seq << 256);
+    if (r.type() != QDBusMessage::ReplyMessage || r.arguments().isEmpty()) {
+        return;
+    }
+    for (QVariant const& v : qdbus_cast<QVariantList>(r.arguments().at(0))) {
+        QVariantMap ev = qdbus_cast<QVariantMap>(v);
+        QString name = ev.value("name").toString();
+        if (signalNames.contains(name)) {
+            handleSignal(name, qdbus_cast<QVariantList>(ev.value("args")));
+            return;
         }
     }
 }
 
 void NDBCli::handleTimeout() {
+    // Following for a set time isn't an error
+    if (follow) {
+        QCoreApplication::quit();
+        return;
+    }
     qCritical() << "timeout expired after" << timeout << "milliseconds";
     QCoreApplication::exit(1);
 }
@@ -242,9 +383,22 @@ void NDBCli::setPrintAPI(bool api) {
     printApi = api;
 }
 
+void NDBCli::setFollow(bool f, int count) {
+    follow = f;
+    followCount = count;
+}
+
+void NDBCli::setJson(bool j) {
+    json = j;
+}
+
+void NDBCli::setBatch(bool b) {
+    batch = b;
+}
+
 void NDBCli::printMethods(int methodType) {
     QTextStream methodOut(stdout);
-    const QMetaObject *mo = ndb->metaObject();
+    const QMetaObject *mo = &NDBProxy::staticMetaObject;
     for (int i = mo->methodOffset(); i < mo->methodCount(); ++ i) {
         QMetaMethod method = mo->method(i);
         if (method.methodType() == methodType) {
@@ -270,28 +424,56 @@ void NDBCli::printAPI() {
 }
 
 void NDBCli::start() {
-    if (!ndb->isValid()) {
-        qCritical() << "interface not valid";
-        QCoreApplication::exit(1);
-    }
     if (printApi) {
         printAPI();
         QCoreApplication::quit();
     }
-    if (signalNames.size() > 0) {
-        connectSignals();
+    if (batch) {
+        runBatch();
+        return;
+    }
+    qulonglong journalSeq = 0;
+    bool haveJournal = false;
+    if (signalNames.size() > 0 || follow) {
+        // A method call finds out from its reply whether NickelDBus is
+        // running. Without one, ask the bus before waiting for signals.
+        if (methodName.isEmpty() && !service.isEmpty() && !conn.interface()->isServiceRegistered(service)) {
+            qCritical() << "NickelDBus is not running";
+            QCoreApplication::exit(1);
+            return;
+        }
+        if (!connectSignals()) {
+            qCritical() << "failed with: " << errString;
+            QCoreApplication::exit(1);
+            return;
+        }
+        // Signals that came in before the subscription are only looked for 
+        // when waiting for a single one
+        if (!methodName.isEmpty() && !follow) {
+            // Older versions of NickelDBus have no journal
+            QDBusMessage r = callInternal("ndbEventsSince", QVariantList() << qulonglong(0) << 0);
+            haveJournal = r.type() == QDBusMessage::ReplyMessage && r.arguments().size() == 2;
+            if (haveJournal) {
+                journalSeq = r.arguments().at(1).toULongLong();
+            }
+        }
     }
     if (!methodName.isEmpty()) {
-        if (callMethodInvoke() != 0) {
+        if (callMethod() != 0) {
             qCritical() << "failed with: " << errString;
             QCoreApplication::exit(1);
         } else {
-            if (signalNames.size() > 0 && signalComplete) {
+            if (follow) {
+                methodComplete = true;
+            } else if (signalNames.size() > 0 && signalComplete) {
                 QCoreApplication::quit();
             } else if (signalNames.size() == 0) {
                 QCoreApplication::quit();
             } else {
                 methodComplete = true;
+                if (haveJournal) {
+                    replayEvents(journalSeq);
+                }
             }
         }
     }
@@ -5,54 +5,56 @@
 #include <QVector>
 #include "../interface/ndb_proxy.h"
 
-struct MethodParamList {
-    struct MethodParam {
-        int type;
-        void *param;
-        QGenericArgument genericArg;
-    };
-    QVector<MethodParam> mp;
-    MethodParamList();
-    ~MethodParamList();
-};
+struct NDBDispatchEntry;
 
 class NDBCli : public QObject {
     Q_OBJECT
 
     public:
-        NDBCli(QObject* parent, com::github::shermp::nickeldbus* ndb);
+        NDBCli(QObject* parent, QDBusConnection const& conn, QString const& service);
 
         void setMethodName(QString name);
         void setMethodArgs(QStringList args);
         void setSignalNames(QStringList names);
         void setTimeout(int timeout);
         void setPrintAPI(bool api);
-        void handleSignalParam0();
-        void handleSignalParam1(QVariant val1);
-        void handleSignalParam2(QVariant val1, QVariant val2);
+        void setFollow(bool follow, int count);
+        void setJson(bool json);
+        void setBatch(bool batch);
     Q_SIGNALS:
         void timeoutTriggered();
     public Q_SLOTS:
         void start();
         void handleTimeout();
+        void handleDBusSignal(QDBusMessage const& msg);
+        void batchCallFinished(QDBusPendingCallWatcher* watcher);
     private:
         QString errString;
         QString methodName;
         QStringList methodArgs;
         QStringList signalNames;
-        bool signalComplete, methodComplete, printApi;
+        bool signalComplete, methodComplete, printApi, follow, json, batch;
+        int followCount, followed;
         int timeout;
-        com::github::shermp::nickeldbus* ndb;
-        int callMethodInvoke();
-        template<typename T>
-        int printMethodReply(void *reply);
-        int printMethodReply(void *reply);
-        bool convertParam(int index, int typeID, void *param);
-        int getMethodIndex();
-        void connectSignals();
+        QDBusConnection conn;
+        QString service;
+        QDBusMessage callInternal(QString const& method, QVariantList const& args);
+        QList<QDBusPendingCall> batchCalls;
+        QStringList batchMethods;
+        int batchNext, batchFailed;
+        const NDBDispatchEntry* findMethod(QString const& name, int argc);
+        bool buildCall(QString const& name, QStringList const& args, QDBusMessage& msg);
+        int callMethod();
+        void runBatch();
+        void printBatch();
+        int printReply(QDBusMessage const& reply);
+        int pipeReply(QDBusUnixFileDescriptor const& fd);
+        bool connectSignals();
+        void replayEvents(qulonglong seq);
         void printMethods(int methodType);
         void printAPI();
-        void handleSignal(const QString& sigName, QVariant = QVariant(), QVariant = QVariant(), QVariant = QVariant(), QVariant = QVariant());
+        void handleSignal(const QString& sigName, QVariantList const& args);
+        void followSignal(const QString& sigName, QVariantList const& args);
 };
 
 #endif
@@ -0,0 +1,101 @@
+// Generated by script/make-cli-dispatch.sh from com.github.shermp.nickeldbus.xml. Do not edit.
+#ifndef NDB_DISPATCH_H
+#define NDB_DISPATCH_H
+
+struct NDBDispatchEntry {
+    const char *name;
+    int argc;
+    const char *args[10]; // D-Bus signature of each argument
+    const char *outSig;
+};
+
+static const NDBDispatchEntry ndbDispatchTable[] = {
+    {"bwmOpenBrowser", 0, {}, ""},
+    {"bwmOpenBrowser", 1, {"b"}, ""},
+    {"bwmOpenBrowser", 2, {"b", "s"}, ""},
+    {"bwmOpenBrowser", 3, {"b", "s", "s"}, ""},
+    {"dlgClose", 1, {"i"}, ""},
+    {"dlgConfirmAccept", 3, {"s", "s", "s"}, ""},
+    {"dlgConfirmAcceptReject", 4, {"s", "s", "s", "s"}, ""},
+    {"dlgConfirmClose", 0, {}, ""},
+    {"dlgConfirmCreate", 0, {}, ""},
+    {"dlgConfirmCreate", 1, {"b"}, ""},
+    {"dlgConfirmForm", 1, {"s"}, "s"},
+    {"dlgConfirmNoBtn", 2, {"s", "s"}, ""},
+    {"dlgConfirmProgressPipe", 1, {"b"}, "h"},
+    {"dlgConfirmReject", 3, {"s", "s", "s"}, ""},
+    {"dlgConfirmSetAccept", 1, {"s"}, ""},
+    {"dlgConfirmSetBody", 1, {"s"}, ""},
+    {"dlgConfirmSetLEPassword", 1, {"b"}, ""},
+    {"dlgConfirmSetLEPlaceholder", 1, {"s"}, ""},
+    {"dlgConfirmSetModal", 1, {"b"}, ""},
+    {"dlgConfirmSetProgress", 3, {"i", "i", "i"}, ""},
+    {"dlgConfirmSetProgress", 4, {"i", "i", "i", "s"}, ""},
+    {"dlgConfirmSetReject", 1, {"s"}, ""},
+    {"dlgConfirmSetTitle", 1, {"s"}, ""},
+    {"dlgConfirmShow", 0, {}, ""},
+    {"dlgConfirmShowClose", 1, {"b"}, ""},
+    {"dlgCreate", 0, {}, "i"},
+    {"dlgCreate", 1, {"b"}, "i"},
+    {"dlgCreate", 2, {"b", "i"}, "i"},
+    {"dlgProgressPipe", 2, {"i", "b"}, "h"},
+    {"dlgPromptConfirm", 5, {"s", "s", "s", "s", "i"}, "i"},
+    {"dlgPromptPassword", 3, {"s", "s", "i"}, "is"},
+    {"dlgPromptText", 3, {"s", "s", "i"}, "is"},
+    {"dlgSetAccept", 2, {"i", "s"}, ""},
+    {"dlgSetBody", 2, {"i", "s"}, ""},
+    {"dlgSetLEPassword", 2, {"i", "b"}, ""},
+    {"dlgSetLEPlaceholder", 2, {"i", "s"}, ""},
+    {"dlgSetModal", 2, {"i", "b"}, ""},
+    {"dlgSetProgress", 4, {"i", "i", "i", "i"}, ""},
+    {"dlgSetProgress", 5, {"i", "i", "i", "i", "s"}, ""},
+    {"dlgSetReject", 2, {"i", "s"}, ""},
+    {"dlgSetTitle", 2, {"i", "s"}, ""},
+    {"dlgShow", 1, {"i"}, ""},
+    {"dlgShowClose", 2, {"i", "b"}, ""},
+    {"imgSizeForType", 1, {"s"}, "s"},
+    {"mwcHome", 0, {}, ""},
+    {"mwcToast", 2, {"i", "s"}, ""},
+    {"mwcToast", 3, {"i", "s", "s"}, ""},
+    {"mwcToastReplace", 3, {"s", "i", "s"}, ""},
+    {"mwcToastReplace", 4, {"s", "i", "s", "s"}, ""},
+    {"n3fssSyncBoth", 0, {}, ""},
+    {"n3fssSyncOnboard", 0, {}, ""},
+    {"n3fssSyncSD", 0, {}, ""},
+    {"ndbCapabilities", 0, {}, "a{sv}"},
+    {"ndbCurrentView", 0, {}, "s"},
+    {"ndbEventsSince", 2, {"t", "i"}, "avt"},
+    {"ndbFirmwareVersion", 0, {}, "s"},
+    {"ndbNickelClassDetails", 1, {"s"}, "s"},
+    {"ndbNickelWidgets", 0, {}, "s"},
+    {"ndbPeerListen", 1, {"b"}, "s"},
+    {"ndbSignalConnected", 1, {"s"}, "b"},
+    {"ndbUsbmsActive", 0, {}, "b"},
+    {"ndbUsbmsDefer", 2, {"b", "i"}, ""},
+    {"ndbVersion", 0, {}, "s"},
+    {"ndbWaitFor", 3, {"s", "s", "i"}, "a{sv}"},
+    {"ndbWifiKeepalive", 1, {"b"}, ""},
+    {"ndbWifiKeepaliveAcquire", 1, {"i"}, "i"},
+    {"ndbWifiKeepaliveRelease", 1, {"i"}, ""},
+    {"ndbWifiKeepaliveRenew", 2, {"i", "i"}, ""},
+    {"nmAction", 2, {"s", "s"}, "s"},
+    {"nmChain", 2, {"as", "b"}, "as"},
+    {"nsApply", 1, {"as"}, "as"},
+    {"nsAutoUSBGadget", 1, {"s"}, ""},
+    {"nsDarkMode", 1, {"s"}, ""},
+    {"nsForceWifi", 1, {"s"}, ""},
+    {"nsInvert", 1, {"s"}, ""},
+    {"nsLockscreen", 1, {"s"}, ""},
+    {"nsScreenshots", 1, {"s"}, ""},
+    {"pfmRescanBooks", 0, {}, ""},
+    {"pfmRescanBooksFull", 0, {}, ""},
+    {"pwrReboot", 0, {}, ""},
+    {"pwrShutdown", 0, {}, ""},
+    {"pwrSleep", 0, {}, ""},
+    {"wfmConnectWireless", 0, {}, ""},
+    {"wfmConnectWirelessSilently", 0, {}, ""},
+    {"wfmSetAirplaneMode", 1, {"s"}, ""},
+    {"wmState", 0, {}, "a{sv}"},
+};
+
+#endif // NDB_DISPATCH_H
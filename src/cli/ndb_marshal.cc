@@ -0,0 +1,401 @@
+#include <QDBusArgument>
+#include <QDBusMetaType>
+#include <QDBusObjectPath>
+#include <QDBusSignature>
+#include <QDBusUnixFileDescriptor>
+#include <QDBusVariant>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <climits>
+#include <cmath>
+#include <string.h>
+
+#include "ndb_marshal.h"
+
+// Arguments are converted from their D-Bus signature alone, so that qndb can
+// call any method without knowing about its types beforehand. Basic types are
+// given as plain strings. Everything else is given as JSON, and written into
+// a QDBusArgument element by element.
+
+static const char basicTypes[] = "ybnqiuxtdsogh";
+
+static bool isBasic(char type) {
+    return type && strchr(basicTypes, type);
+}
+
+// Length of the single complete type at the start of sig, or 0 if it is malformed
+static int typeLength(const char *sig) {
+    switch (*sig) {
+        case 'a': {
+            int n = typeLength(sig + 1);
+            return n ? n + 1 : 0;
+        }
+        case '(':
+        case '{': {
+            char close = (*sig == '(') ? ')' : '}';
+            int pos = 1;
+            while (sig[pos] != close) {
+                int n = typeLength(sig + pos);
+                if (!n) { return 0; }
+                pos += n;
+            }
+            return pos + 1;
+        }
+        default:
+            return (isBasic(*sig) || *sig == 'v') ? 1 : 0;
+    }
+}
+
+static bool basicFromString(char type, QString const& s, QVariant& out) {
+    bool ok = true;
+    switch (type) {
+        case 'y': {
+            uint v = s.toUInt(&ok);
+            ok = ok && v <= 0xff;
+            out = QVariant::fromValue(uchar(v));
+            break;
+        }
+        case 'b':
+            if (!s.compare("true", Qt::CaseInsensitive) || !s.compare("t", Qt::CaseInsensitive)) {
+                out = true;
+            } else if (!s.compare("false", Qt::CaseInsensitive) || !s.compare("f", Qt::CaseInsensitive)) {
+                out = false;
+            } else {
+                ok = false;
+            }
+            break;
+        case 'n': out = QVariant::fromValue(s.toShort(&ok)); break;
+        case 'q': out = QVariant::fromValue(s.toUShort(&ok)); break;
+        case 'i': out = s.toInt(&ok); break;
+        case 'u': out = s.toUInt(&ok); break;
+        case 'x': out = s.toLongLong(&ok); break;
+        case 't': out = s.toULongLong(&ok); break;
+        case 'd': out = s.toDouble(&ok); break;
+        case 's': out = s; break;
+        case 'o': {
+            // Invalid paths and signatures are cleared on construction
+            QDBusObjectPath p(s);
+            ok = !p.path().isEmpty();
+            out = QVariant::fromValue(p);
+            break;
+        }
+        case 'g': {
+            QDBusSignature g(s);
+            ok = !g.signature().isEmpty() || s.isEmpty();
+            out = QVariant::fromValue(g);
+            break;
+        }
+        case 'h': {
+            // A file descriptor of ours, such as 0 for stdin
+            QDBusUnixFileDescriptor fd(s.toInt(&ok));
+            ok = ok && fd.isValid();
+            out = QVariant::fromValue(fd);
+            break;
+        }
+        default:
+            ok = false;
+            break;
+    }
+    return ok;
+}
+
+static bool basicFromJson(char type, QJsonValue const& v, QVariant& out) {
+    if (v.isString()) {
+        return basicFromString(type, v.toString(), out);
+    } else if (v.isBool() && type == 'b') {
+        out = v.toBool();
+        return true;
+    } else if (v.isDouble() && strchr("ynqiuxtdh", type)) {
+        // Integer types reject anything with a fraction or out of range
+        return basicFromString(type, QString::number(v.toDouble(), 'g', 17), out);
+    }
+    return false;
+}
+
+static void appendBasic(QDBusArgument& arg, char type, QVariant const& v) {
+    switch (type) {
+        case 'y': arg << v.value<uchar>(); break;
+        case 'b': arg << v.toBool(); break;
+        case 'n': arg << v.value<short>(); break;
+        case 'q': arg << v.value<ushort>(); break;
+        case 'i': arg << v.toInt(); break;
+        case 'u': arg << v.toUInt(); break;
+        case 'x': arg << v.toLongLong(); break;
+        case 't': arg << v.toULongLong(); break;
+        case 'd': arg << v.toDouble(); break;
+        case 's': arg << v.toString(); break;
+        case 'o': arg << v.value<QDBusObjectPath>(); break;
+        case 'g': arg << v.value<QDBusSignature>(); break;
+        case 'h': arg << v.value<QDBusUnixFileDescriptor>(); break;
+    }
+}
+
+// The contents of a variant get the narrowest type that holds them: whole
+// numbers become int or qlonglong, arrays av and objects a{sv}
+static bool jsonToVariant(QJsonValue const& v, QVariant& out) {
+    switch (v.type()) {
+        case QJsonValue::Bool:
+            out = v.toBool();
+            return true;
+        case QJsonValue::Double: {
+            double d = v.toDouble();
+            if (d != std::floor(d) || std::fabs(d) >= 9.2e18) {
+                out = d;
+            } else if (d >= INT_MIN && d <= INT_MAX) {
+                out = int(d);
+            } else {
+                out = qlonglong(d);
+            }
+            return true;
+        }
+        case QJsonValue::String:
+            out = v.toString();
+            return true;
+        case QJsonValue::Array: {
+            QVariantList list;
+            for (QJsonValue const& item : v.toArray()) {
+                QVariant iv;
+                if (!jsonToVariant(item, iv)) { return false; }
+                list.append(iv);
+            }
+            out = list;
+            return true;
+        }
+        case QJsonValue::Object: {
+            QVariantMap map;
+            QJsonObject obj = v.toObject();
+            for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+                QVariant iv;
+                if (!jsonToVariant(it.value(), iv)) { return false; }
+                map.insert(it.key(), iv);
+            }
+            out = map;
+            return true;
+        }
+        default:
+            // D-Bus has no null
+            return false;
+    }
+}
+
+// Write v into arg as the single complete type of len bytes at sig. Array and
+// map elements need a registered Qt type for their signature, which covers
+// basic types, variants, as, ay, av, a{sv} and lists of basic types.
+static bool marshal(QDBusArgument& arg, const char *sig, int len, QJsonValue const& v) {
+    QByteArray type(sig, len);
+    if (len == 1 && isBasic(sig[0])) {
+        QVariant b;
+        if (!basicFromJson(sig[0], v, b)) { return false; }
+        appendBasic(arg, sig[0], b);
+    } else if (type == "v") {
+        QVariant var;
+        if (!jsonToVariant(v, var)) { return false; }
+        arg << QDBusVariant(var);
+    } else if (type == "ay") {
+        // Either a string, or an array of byte values
+        QByteArray bytes;
+        if (v.isString()) {
+            bytes = v.toString().toUtf8();
+        } else if (v.isArray()) {
+            for (QJsonValue const& item : v.toArray()) {
+                QVariant b;
+                if (!basicFromJson('y', item, b)) { return false; }
+                bytes.append(char(b.value<uchar>()));
+            }
+        } else {
+            return false;
+        }
+        arg << bytes;
+    } else if (type.startsWith("a{")) {
+        int keyLen = typeLength(sig + 2);
+        QByteArray keyType(sig + 2, keyLen);
+        QByteArray valType(sig + 2 + keyLen, len - 3 - keyLen);
+        int keyId = QDBusMetaType::signatureToType(keyType);
+        int valId = QDBusMetaType::signatureToType(valType);
+        if (!v.isObject() || keyId == QMetaType::UnknownType || valId == QMetaType::UnknownType) {
+            return false;
+        }
+        QJsonObject obj = v.toObject();
+        arg.beginMap(keyId, valId);
+        for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+            QVariant key;
+            if (!basicFromString(keyType.at(0), it.key(), key)) { return false; }
+            arg.beginMapEntry();
+            appendBasic(arg, keyType.at(0), key);
+            if (!marshal(arg, valType.constData(), valType.size(), it.value())) { return false; }
+            arg.endMapEntry();
+        }
+        arg.endMap();
+    } else if (sig[0] == 'a') {
+        int elemId = QDBusMetaType::signatureToType(type.mid(1));
+        if (!v.isArray() || elemId == QMetaType::UnknownType) {
+            return false;
+        }
+        arg.beginArray(elemId);
+        for (QJsonValue const& item : v.toArray()) {
+            if (!marshal(arg, sig + 1, len - 1, item)) { return false; }
+        }
+        arg.endArray();
+    } else if (sig[0] == '(') {
+        // Structures are given as an array of their fields
+        if (!v.isArray()) { return false; }
+        QJsonArray fields = v.toArray();
+        int pos = 1, i = 0;
+        arg.beginStructure();
+        for (; pos < len - 1; ++i) {
+            int n = typeLength(sig + pos);
+            if (i >= fields.size() || !marshal(arg, sig + pos, n, fields.at(i))) { return false; }
+            pos += n;
+        }
+        arg.endStructure();
+        return i == fields.size();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Convert the command line argument \a arg to the D-Bus type \a sig
+ *
+ * Basic types are given as is. Lists of strings may also be given one item
+ * per line. Everything else is given as JSON: arrays and structures as JSON
+ * arrays, maps as JSON objects, and variants as any JSON value, or a plain
+ * string. Returns \c false if \a arg doesn't fit \a sig.
+ */
+bool ndbArgFromString(QByteArray const& sig, QString const& arg, QVariant& out) {
+    if (sig.isEmpty() || typeLength(sig.constData()) != sig.size()) {
+        return false;
+    }
+    if (sig.size() == 1 && isBasic(sig.at(0))) {
+        return basicFromString(sig.at(0), arg, out);
+    }
+    if (sig == "as" && !arg.trimmed().startsWith('[')) {
+        out = arg.split('\n', QString::SkipEmptyParts);
+        return true;
+    }
+    // Only objects and arrays are JSON documents, so wrap the argument to
+    // allow for bare values
+    QJsonDocument doc = QJsonDocument::fromJson(QString("[%1]").arg(arg).toUtf8());
+    if (doc.isNull() || doc.array().size() != 1) {
+        if (sig == "v") {
+            out = QVariant::fromValue(QDBusVariant(arg));
+            return true;
+        }
+        return false;
+    }
+    QDBusArgument dbusArg;
+    if (!marshal(dbusArg, sig.constData(), sig.size(), doc.array().at(0))) {
+        return false;
+    }
+    out = QVariant::fromValue(dbusArg);
+    return true;
+}
+
+static QJsonValue argumentToJson(QDBusArgument const& arg) {
+    switch (arg.currentType()) {
+        case QDBusArgument::BasicType:
+        case QDBusArgument::VariantType:
+            return ndbArgToJson(arg.asVariant());
+        case QDBusArgument::ArrayType: {
+            QJsonArray arr;
+            arg.beginArray();
+            while (!arg.atEnd()) {
+                arr.append(argumentToJson(arg));
+            }
+            arg.endArray();
+            return arr;
+        }
+        case QDBusArgument::StructureType: {
+            QJsonArray arr;
+            arg.beginStructure();
+            while (!arg.atEnd()) {
+                arr.append(argumentToJson(arg));
+            }
+            arg.endStructure();
+            return arr;
+        }
+        case QDBusArgument::MapType: {
+            QJsonObject obj;
+            arg.beginMap();
+            while (!arg.atEnd()) {
+                arg.beginMapEntry();
+                QString key = argumentToJson(arg).toVariant().toString();
+                obj.insert(key, argumentToJson(arg));
+                arg.endMapEntry();
+            }
+            arg.endMap();
+            return obj;
+        }
+        default:
+            return QJsonValue();
+    }
+}
+
+/*!
+ * \internal
+ * \brief Convert a reply or signal argument of any D-Bus type to JSON
+ *
+ * Structures become arrays of their fields, maps objects with their keys as
+ * strings, and byte arrays arrays of numbers. File descriptors become their
+ * number.
+ */
+QJsonValue ndbArgToJson(QVariant const& arg) {
+    int type = arg.userType();
+    if (type == qMetaTypeId<QDBusArgument>()) {
+        return argumentToJson(qvariant_cast<QDBusArgument>(arg));
+    } else if (type == qMetaTypeId<QDBusVariant>()) {
+        return ndbArgToJson(qvariant_cast<QDBusVariant>(arg).variant());
+    } else if (type == qMetaTypeId<QDBusObjectPath>()) {
+        return qvariant_cast<QDBusObjectPath>(arg).path();
+    } else if (type == qMetaTypeId<QDBusSignature>()) {
+        return qvariant_cast<QDBusSignature>(arg).signature();
+    } else if (type == qMetaTypeId<QDBusUnixFileDescriptor>()) {
+        return qvariant_cast<QDBusUnixFileDescriptor>(arg).fileDescriptor();
+    }
+    switch (type) {
+        case QMetaType::Bool:
+            return arg.toBool();
+        case QMetaType::UChar:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Double:
+            return arg.toDouble();
+        case QMetaType::QString:
+            return arg.toString();
+        case QMetaType::QByteArray: {
+            QJsonArray arr;
+            for (char c : arg.toByteArray()) {
+                arr.append(int(uchar(c)));
+            }
+            return arr;
+        }
+        case QMetaType::QStringList:
+            return QJsonArray::fromStringList(arg.toStringList());
+        case QMetaType::QVariantList: {
+            QJsonArray arr;
+            for (QVariant const& item : arg.toList()) {
+                arr.append(ndbArgToJson(item));
+            }
+            return arr;
+        }
+        case QMetaType::QVariantMap: {
+            QJsonObject obj;
+            QVariantMap map = arg.toMap();
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                obj.insert(it.key(), ndbArgToJson(it.value()));
+            }
+            return obj;
+        }
+        default:
+            return QJsonValue::fromVariant(arg);
+    }
+}
@@ -0,0 +1,12 @@
+#ifndef NICKEL_DBUS_CLI_MARSHAL_H
+#define NICKEL_DBUS_CLI_MARSHAL_H
+
+#include <QByteArray>
+#include <QJsonValue>
+#include <QString>
+#include <QVariant>
+
+bool ndbArgFromString(QByteArray const& sig, QString const& arg, QVariant& out);
+QJsonValue ndbArgToJson(QVariant const& arg);
+
+#endif
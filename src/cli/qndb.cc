@@ -1,6 +1,7 @@
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <QTextStream>
 
 #include "ndb_cli.h"
 
@@ -17,28 +18,62 @@ int main(int argc, char **argv) {
     parser.addPositionalArgument("arguments", "Arguments to pass to method. Have no affect when a method is not set.", "[args...]");
 
     QCommandLineOption signalOption(QStringList() << "s" << "signal", "Wait for signal, and prints its output, if any.", "signal name");
-    QCommandLineOption timeoutOption(QStringList() << "t" << "timeout", "Signal timeout in milliseconds.", "timeout ms");
+    QCommandLineOption timeoutOption(QStringList() << "t" << "timeout", "Signal and method reply timeout in milliseconds.", "timeout ms");
     QCommandLineOption methodOption(QStringList() << "m" << "method", "Method to invoke.", "method name");
     QCommandLineOption apiOption(QStringList() << "a" << "api", "Print API usage");
+    QCommandLineOption peerOption(QStringList() << "p" << "peer", "Connect directly to NickelDBus instead of through the system bus. NickelDBus must be listening, see ndbPeerListen.");
+    QCommandLineOption followOption(QStringList() << "f" << "follow", "Keep printing signals as they arrive, one JSON object per line. Follows every signal if no signal is set.");
+    QCommandLineOption countOption(QStringList() << "c" << "count", "With --follow, exit after this many signals.", "count");
+    QCommandLineOption jsonOption(QStringList() << "j" << "json", "Print the method reply as a JSON array.");
+    QCommandLineOption batchOption(QStringList() << "b" << "batch", "Read calls from stdin, one JSON array of the method and its arguments per line, and send them without waiting for each reply. Replies are printed as JSON, one per line, in the same order.");
     parser.addOption(signalOption);
     parser.addOption(timeoutOption);
     parser.addOption(methodOption);
     parser.addOption(apiOption);
+    parser.addOption(peerOption);
+    parser.addOption(followOption);
+    parser.addOption(countOption);
+    parser.addOption(jsonOption);
+    parser.addOption(batchOption);
 
     parser.process(app);
 
     const QStringList methodArgs = parser.positionalArguments();
 
-    com::github::shermp::nickeldbus ndb("com.github.shermp.nickeldbus", "/nickeldbus", QDBusConnection::systemBus(), &app);
-    NDBCli cli(&app, &ndb);
+    QString service = "com.github.shermp.nickeldbus";
+    QDBusConnection conn = QDBusConnection::systemBus();
+    if (parser.isSet(peerOption)) {
+        // Peer connections have no bus daemon, and so no service names
+        service = QString();
+        conn = QDBusConnection::connectToPeer("unix:path=/tmp/nickeldbus-peer", "qndb-peer");
+        if (!conn.isConnected()) {
+            QTextStream(stderr) << "could not connect to NickelDBus peer socket: " << conn.lastError().message() << endl;
+            return 1;
+        }
+    }
+    NDBCli cli(&app, conn, service);
 
     cli.setPrintAPI(parser.isSet(apiOption));
+    cli.setJson(parser.isSet(jsonOption));
+    cli.setBatch(parser.isSet(batchOption));
     if (parser.isSet(signalOption)) {
         cli.setSignalNames(parser.values(signalOption));
     }
     if (parser.isSet(methodOption)) {
         cli.setMethodName(parser.value(methodOption));
     }
+    if (parser.isSet(followOption)) {
+        int count = 0;
+        if (parser.isSet(countOption)) {
+            bool count_ok;
+            count = parser.value(countOption).toInt(&count_ok);
+            if (!count_ok || count < 1) {
+                QTextStream(stderr) << "count must be a positive number" << endl;
+                return 1;
+            }
+        }
+        cli.setFollow(true, count);
+    }
     if (parser.isSet(timeoutOption)) {
         int timeout = -1;
         bool timeout_ok;
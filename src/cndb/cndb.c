@@ -0,0 +1,292 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ndb_client.h"
+
+#define CNDB_MAX_SIGNALS 32
+
+static void usage(FILE *f) {
+    fprintf(f,
+        "Usage: cndb [options] [args...]\n"
+        "Plain C CLI for NickelDBus\n"
+        "\n"
+        "Options:\n"
+        "  -h                Displays this help.\n"
+        "  -s <signal name>  Wait for signal, and prints its output, if any.\n"
+        "  -t <timeout ms>   Time to wait for the method reply and signal, in\n"
+        "                    milliseconds, all together.\n"
+        "  -m <method name>  Method to invoke.\n"
+        "  -p                Connect directly to NickelDBus instead of through\n"
+        "                    the system bus. NickelDBus must be listening, see\n"
+        "                    ndbPeerListen.\n"
+        "\n"
+        "Arguments:\n"
+        "  args              Arguments to pass to method. Lists of strings are\n"
+        "                    given one item per line. Methods taking other\n"
+        "                    containers need qndb.\n");
+}
+
+// Print a value on the current line, formatted like QVariant::toString() as
+// qndb does. Containers are printed with their items separated by spaces.
+static void print_inline(DBusMessageIter *it) {
+    int type = dbus_message_iter_get_arg_type(it);
+    if (dbus_type_is_container(type)) {
+        DBusMessageIter sub;
+        dbus_message_iter_recurse(it, &sub);
+        for (int first = 1; dbus_message_iter_get_arg_type(&sub) != DBUS_TYPE_INVALID; dbus_message_iter_next(&sub), first = 0) {
+            if (!first && type != DBUS_TYPE_VARIANT) {
+                putchar(' ');
+            }
+            print_inline(&sub);
+        }
+        return;
+    }
+    // DBusBasicValue isn't public in older versions of libdbus
+    union {
+        dbus_bool_t b;
+        unsigned char y;
+        dbus_int16_t i16;
+        dbus_uint16_t u16;
+        dbus_int32_t i32;
+        dbus_uint32_t u32;
+        dbus_int64_t i64;
+        dbus_uint64_t u64;
+        double dbl;
+        int fd;
+        const char *str;
+    } v;
+    dbus_message_iter_get_basic(it, &v);
+    switch (type) {
+        case DBUS_TYPE_BOOLEAN: fputs(v.b ? "true" : "false", stdout); break;
+        case DBUS_TYPE_BYTE:    printf("%u", v.y); break;
+        case DBUS_TYPE_INT16:   printf("%d", v.i16); break;
+        case DBUS_TYPE_UINT16:  printf("%u", v.u16); break;
+        case DBUS_TYPE_INT32:   printf("%d", v.i32); break;
+        case DBUS_TYPE_UINT32:  printf("%u", v.u32); break;
+        case DBUS_TYPE_INT64:   printf("%lld", (long long) v.i64); break;
+        case DBUS_TYPE_UINT64:  printf("%llu", (unsigned long long) v.u64); break;
+        case DBUS_TYPE_DOUBLE:  printf("%.15g", v.dbl); break;
+        case DBUS_TYPE_UNIX_FD: printf("%d", v.fd); break;
+        default:                fputs(v.str, stdout); break;
+    }
+}
+
+// Print an ndbEventsSince event (an a{sv} map) as qndb does, on one line as
+// 'seq time name args...'
+static void print_event(DBusMessageIter *map) {
+    static const char *const keys[] = {"seq", "time", "name", "args"};
+    DBusMessageIter vals[4];
+    int found[4] = {0};
+    DBusMessageIter entry, sub;
+    for (dbus_message_iter_recurse(map, &sub); dbus_message_iter_get_arg_type(&sub) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&sub)) {
+        const char *key;
+        dbus_message_iter_recurse(&sub, &entry);
+        if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_STRING) {
+            continue;
+        }
+        dbus_message_iter_get_basic(&entry, &key);
+        dbus_message_iter_next(&entry);
+        for (int i = 0; i < 4; ++i) {
+            if (!strcmp(key, keys[i])) {
+                vals[i] = entry;
+                found[i] = 1;
+            }
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (i > 0) {
+            putchar(' ');
+        }
+        if (found[i]) {
+            print_inline(&vals[i]);
+        }
+    }
+    if (found[3]) {
+        // A variant holding the list of arguments
+        DBusMessageIter list, arg;
+        dbus_message_iter_recurse(&vals[3], &list);
+        if (dbus_message_iter_get_arg_type(&list) == DBUS_TYPE_ARRAY) {
+            for (dbus_message_iter_recurse(&list, &arg); dbus_message_iter_get_arg_type(&arg) != DBUS_TYPE_INVALID; dbus_message_iter_next(&arg)) {
+                putchar(' ');
+                print_inline(&arg);
+            }
+        }
+    }
+}
+
+// Methods returning a file descriptor hand out a pipe. Copy our stdin to it
+// until EOF, as qndb does.
+static int pipe_reply(int fd) {
+    char buf[512];
+    ssize_t n;
+    signal(SIGPIPE, SIG_IGN);
+    while ((n = read(STDIN_FILENO, buf, sizeof(buf))) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            fprintf(stderr, "error reading stdin: %s\n", strerror(errno));
+            close(fd);
+            return -1;
+        }
+        for (ssize_t off = 0; off < n;) {
+            ssize_t w = write(fd, buf + off, n - off);
+            if (w < 0) {
+                if (errno == EINTR) { continue; }
+                fprintf(stderr, "error writing to pipe: %s\n", strerror(errno));
+                close(fd);
+                return -1;
+            }
+            off += w;
+        }
+    }
+    close(fd);
+    return 0;
+}
+
+// Print each argument of the reply on its own line, in order, the same way
+// as qndb. Lists get one line per item, and maps one 'key value' line per key.
+// Lists of variants are ndbEventsSince events, printed as by print_event().
+// A boolean on its own is printed as 1 or 0, as qndb does for replies.
+static int print_reply(DBusMessage *reply) {
+    DBusMessageIter it;
+    if (!dbus_message_iter_init(reply, &it)) {
+        return 0;
+    }
+    do {
+        int type = dbus_message_iter_get_arg_type(&it);
+        if (type == DBUS_TYPE_UNIX_FD) {
+            int fd;
+            dbus_message_iter_get_basic(&it, &fd);
+            return pipe_reply(fd);
+        } else if (type == DBUS_TYPE_ARRAY) {
+            DBusMessageIter sub;
+            dbus_message_iter_recurse(&it, &sub);
+            for (; dbus_message_iter_get_arg_type(&sub) != DBUS_TYPE_INVALID; dbus_message_iter_next(&sub)) {
+                DBusMessageIter var;
+                if (dbus_message_iter_get_arg_type(&sub) == DBUS_TYPE_VARIANT) {
+                    dbus_message_iter_recurse(&sub, &var);
+                }
+                if (dbus_message_iter_get_arg_type(&sub) == DBUS_TYPE_VARIANT && dbus_message_iter_get_arg_type(&var) == DBUS_TYPE_ARRAY &&
+                    dbus_message_iter_get_element_type(&var) == DBUS_TYPE_DICT_ENTRY) {
+                    print_event(&var);
+                } else if (dbus_message_iter_get_arg_type(&sub) == DBUS_TYPE_DICT_ENTRY) {
+                    DBusMessageIter entry;
+                    dbus_message_iter_recurse(&sub, &entry);
+                    print_inline(&entry);
+                    putchar(' ');
+                    dbus_message_iter_next(&entry);
+                    print_inline(&entry);
+                } else {
+                    print_inline(&sub);
+                }
+                putchar('\n');
+            }
+        } else if (type == DBUS_TYPE_BOOLEAN) {
+            dbus_bool_t b;
+            dbus_message_iter_get_basic(&it, &b);
+            printf("%d\n", b ? 1 : 0);
+        } else {
+            print_inline(&it);
+            putchar('\n');
+        }
+    } while (dbus_message_iter_next(&it));
+    return 0;
+}
+
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+int main(int argc, char **argv) {
+    const char *method = NULL;
+    const char *signals[CNDB_MAX_SIGNALS];
+    int nsignals = 0, timeout = -1, peer = 0, opt;
+    while ((opt = getopt(argc, argv, "+hs:t:m:p")) != -1) {
+        switch (opt) {
+            case 'h':
+                usage(stdout);
+                return 0;
+            case 's':
+                if (nsignals == CNDB_MAX_SIGNALS) {
+                    fprintf(stderr, "too many signals\n");
+                    return 1;
+                }
+                signals[nsignals++] = optarg;
+                break;
+            case 't':
+                timeout = atoi(optarg);
+                break;
+            case 'm':
+                method = optarg;
+                break;
+            case 'p':
+                peer = 1;
+                break;
+            default:
+                usage(stderr);
+                return 1;
+        }
+    }
+    if (!method && nsignals == 0) {
+        usage(stderr);
+        return 1;
+    }
+
+    ndb_conn *ndb = ndb_open(peer);
+    if (!ndb || ndb_error(ndb)) {
+        fprintf(stderr, "could not connect to NickelDBus: %s\n", ndb ? ndb_error(ndb) : "out of memory");
+        ndb_close(ndb);
+        return 1;
+    }
+    // One deadline covers both the method call and the wait for a signal
+    long long deadline = now_ms() + timeout;
+    ndb_set_timeout(ndb, timeout);
+    int ret = 0;
+    // Subscribe first, so that signals caused by the method can't be missed
+    for (int i = 0; i < nsignals && ret == 0; ++i) {
+        if (ndb_subscribe(ndb, signals[i]) != 0) {
+            fprintf(stderr, "failed with: %s\n", ndb_error(ndb));
+            ret = 1;
+        }
+    }
+    if (ret == 0 && method) {
+        DBusMessage *reply = ndb_call_strings(ndb, method, argc - optind, argv + optind);
+        if (!reply) {
+            fprintf(stderr, "failed with: %s\n", ndb_error(ndb));
+            ret = 1;
+        } else {
+            ret = print_reply(reply) == 0 ? 0 : 1;
+            ndb_reply_free(reply);
+        }
+    }
+    if (ret == 0 && nsignals > 0) {
+        long long left = deadline - now_ms();
+        DBusMessage *sig = ndb_wait_signal(ndb, timeout > 0 ? (left > 0 ? (int) left : 0) : -1);
+        if (!sig && timeout > 0 && now_ms() >= deadline) {
+            fprintf(stderr, "timeout expired after %d milliseconds\n", timeout);
+            ret = 1;
+        } else if (!sig) {
+            fprintf(stderr, "%s\n", ndb_error(ndb));
+            ret = 1;
+        } else {
+            DBusMessageIter it;
+            fputs(dbus_message_get_member(sig), stdout);
+            if (dbus_message_iter_init(sig, &it)) {
+                do {
+                    putchar(' ');
+                    print_inline(&it);
+                } while (dbus_message_iter_next(&it));
+            }
+            putchar('\n');
+            ndb_reply_free(sig);
+        }
+    }
+    ndb_close(ndb);
+    return ret;
+}
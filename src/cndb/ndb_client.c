@@ -0,0 +1,361 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "ndb_client.h"
+
+#define NDB_MAX_SIGNALS 32
+
+struct ndb_conn {
+    DBusConnection *conn;
+    const char *dest;   // NULL for peer connections, which have no bus names
+    int timeout;
+    int all_signals;
+    int nsignals;
+    char *signals[NDB_MAX_SIGNALS];
+    int failed;
+    char error[512];
+};
+
+static void ndb_set_error(ndb_conn *ndb, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(ndb->error, sizeof(ndb->error), fmt, ap);
+    va_end(ap);
+    ndb->failed = 1;
+}
+
+static void ndb_set_dbus_error(ndb_conn *ndb, DBusError *err) {
+    ndb_set_error(ndb, "%s: %s", err->name, err->message);
+    dbus_error_free(err);
+}
+
+ndb_conn *ndb_open(int peer) {
+    ndb_conn *ndb = calloc(1, sizeof(*ndb));
+    if (!ndb) {
+        return NULL;
+    }
+    ndb->timeout = INT_MAX;
+    DBusError err;
+    dbus_error_init(&err);
+    if (peer) {
+        ndb->conn = dbus_connection_open_private(NDB_PEER_ADDRESS, &err);
+    } else {
+        ndb->dest = NDB_SERVICE;
+        ndb->conn = dbus_bus_get_private(DBUS_BUS_SYSTEM, &err);
+    }
+    if (!ndb->conn) {
+        ndb_set_dbus_error(ndb, &err);
+        return ndb;
+    }
+    dbus_connection_set_exit_on_disconnect(ndb->conn, FALSE);
+    return ndb;
+}
+
+void ndb_close(ndb_conn *ndb) {
+    if (!ndb) {
+        return;
+    }
+    if (ndb->conn) {
+        dbus_connection_close(ndb->conn);
+        dbus_connection_unref(ndb->conn);
+    }
+    for (int i = 0; i < ndb->nsignals; ++i) {
+        free(ndb->signals[i]);
+    }
+    free(ndb);
+}
+
+const char *ndb_error(ndb_conn *ndb) {
+    return ndb->failed ? ndb->error : NULL;
+}
+
+void ndb_set_timeout(ndb_conn *ndb, int timeout_ms) {
+    ndb->timeout = timeout_ms > 0 ? timeout_ms : INT_MAX;
+}
+
+static DBusMessage *ndb_new_call(ndb_conn *ndb, const char *method) {
+    ndb->failed = 0;
+    if (!ndb->conn) {
+        ndb_set_error(ndb, "not connected");
+        return NULL;
+    }
+    DBusMessage *msg = dbus_message_new_method_call(ndb->dest, NDB_PATH, NDB_INTERFACE, method);
+    if (!msg) {
+        ndb_set_error(ndb, "out of memory");
+    }
+    return msg;
+}
+
+// Send msg and wait for the reply. Error replies are turned into errors.
+static DBusMessage *ndb_send(ndb_conn *ndb, DBusMessage *msg) {
+    DBusError err;
+    dbus_error_init(&err);
+    DBusMessage *reply = dbus_connection_send_with_reply_and_block(ndb->conn, msg, ndb->timeout, &err);
+    dbus_message_unref(msg);
+    if (!reply) {
+        ndb_set_dbus_error(ndb, &err);
+    }
+    return reply;
+}
+
+DBusMessage *ndb_call(ndb_conn *ndb, const char *method, int first_type, ...) {
+    DBusMessage *msg = ndb_new_call(ndb, method);
+    if (!msg) {
+        return NULL;
+    }
+    va_list ap;
+    va_start(ap, first_type);
+    dbus_bool_t ok = dbus_message_append_args_valist(msg, first_type, ap);
+    va_end(ap);
+    if (!ok) {
+        ndb_set_error(ndb, "unable to append arguments for %s", method);
+        dbus_message_unref(msg);
+        return NULL;
+    }
+    return ndb_send(ndb, msg);
+}
+
+static int ndb_method_cmp(const void *key, const void *elem) {
+    const struct ndb_method *k = key, *e = elem;
+    int c = strcmp(k->name, e->name);
+    return c ? c : k->argc - e->argc;
+}
+
+// Append arg as the basic type, or list of strings, at it
+static int ndb_append_string(DBusMessageIter *it, int type, const char *arg) {
+    char *end = NULL;
+    errno = 0;
+    switch (type) {
+        case DBUS_TYPE_BOOLEAN: {
+            dbus_bool_t v;
+            if (!strcasecmp(arg, "true") || !strcasecmp(arg, "t")) {
+                v = TRUE;
+            } else if (!strcasecmp(arg, "false") || !strcasecmp(arg, "f")) {
+                v = FALSE;
+            } else {
+                return -1;
+            }
+            return dbus_message_iter_append_basic(it, type, &v) ? 0 : -1;
+        }
+        case DBUS_TYPE_BYTE:
+        case DBUS_TYPE_INT16:
+        case DBUS_TYPE_INT32:
+        case DBUS_TYPE_INT64: {
+            long long v = strtoll(arg, &end, 10);
+            if (!*arg || *end || errno) {
+                return -1;
+            }
+            dbus_int64_t v64 = v;
+            dbus_int32_t v32 = v;
+            dbus_int16_t v16 = v;
+            unsigned char v8 = v;
+            if (type == DBUS_TYPE_BYTE) {
+                return (v < 0 || v > 0xff || !dbus_message_iter_append_basic(it, type, &v8)) ? -1 : 0;
+            } else if (type == DBUS_TYPE_INT16) {
+                return (v != v16 || !dbus_message_iter_append_basic(it, type, &v16)) ? -1 : 0;
+            } else if (type == DBUS_TYPE_INT32) {
+                return (v != v32 || !dbus_message_iter_append_basic(it, type, &v32)) ? -1 : 0;
+            }
+            return dbus_message_iter_append_basic(it, type, &v64) ? 0 : -1;
+        }
+        case DBUS_TYPE_UINT16:
+        case DBUS_TYPE_UINT32:
+        case DBUS_TYPE_UINT64: {
+            unsigned long long v = strtoull(arg, &end, 10);
+            if (!*arg || *end || errno || *arg == '-') {
+                return -1;
+            }
+            dbus_uint64_t v64 = v;
+            dbus_uint32_t v32 = v;
+            dbus_uint16_t v16 = v;
+            if (type == DBUS_TYPE_UINT16) {
+                return (v != v16 || !dbus_message_iter_append_basic(it, type, &v16)) ? -1 : 0;
+            } else if (type == DBUS_TYPE_UINT32) {
+                return (v != v32 || !dbus_message_iter_append_basic(it, type, &v32)) ? -1 : 0;
+            }
+            return dbus_message_iter_append_basic(it, type, &v64) ? 0 : -1;
+        }
+        case DBUS_TYPE_DOUBLE: {
+            double v = strtod(arg, &end);
+            if (!*arg || *end || errno) {
+                return -1;
+            }
+            return dbus_message_iter_append_basic(it, type, &v) ? 0 : -1;
+        }
+        case DBUS_TYPE_STRING:
+        case DBUS_TYPE_OBJECT_PATH:
+            // libdbus aborts the program on invalid strings instead of failing
+            if (!dbus_validate_utf8(arg, NULL) || (type == DBUS_TYPE_OBJECT_PATH && !dbus_validate_path(arg, NULL))) {
+                return -1;
+            }
+            return dbus_message_iter_append_basic(it, type, &arg) ? 0 : -1;
+        default:
+            return -1;
+    }
+}
+
+DBusMessage *ndb_call_strings(ndb_conn *ndb, const char *method, int argc, char *const *argv) {
+    struct ndb_method key = { method, argc, NULL };
+    const struct ndb_method *m = bsearch(&key, ndb_methods, ndb_method_count, sizeof(ndb_methods[0]), ndb_method_cmp);
+    if (!m) {
+        ndb->failed = 0;
+        ndb_set_error(ndb, "non-existent method or invalid parameter count");
+        return NULL;
+    }
+    DBusMessage *msg = ndb_new_call(ndb, method);
+    if (!msg) {
+        return NULL;
+    }
+    DBusMessageIter it;
+    DBusSignatureIter sig;
+    dbus_message_iter_init_append(msg, &it);
+    dbus_signature_iter_init(&sig, m->in_sig);
+    for (int i = 0; i < argc; ++i, dbus_signature_iter_next(&sig)) {
+        int type = dbus_signature_iter_get_current_type(&sig);
+        int ret;
+        if (type == DBUS_TYPE_ARRAY && dbus_signature_iter_get_element_type(&sig) == DBUS_TYPE_STRING) {
+            // One list item per line
+            DBusMessageIter sub;
+            char *items = strdup(argv[i]), *save = NULL;
+            ret = (items && dbus_message_iter_open_container(&it, DBUS_TYPE_ARRAY, DBUS_TYPE_STRING_AS_STRING, &sub)) ? 0 : -1;
+            for (char *item = ret ? NULL : strtok_r(items, "\n", &save); item; item = strtok_r(NULL, "\n", &save)) {
+                if (!dbus_message_iter_append_basic(&sub, DBUS_TYPE_STRING, &item)) {
+                    ret = -1;
+                }
+            }
+            if (ret == 0 && !dbus_message_iter_close_container(&it, &sub)) {
+                ret = -1;
+            }
+            free(items);
+        } else if (dbus_type_is_basic(type) && type != DBUS_TYPE_UNIX_FD && type != DBUS_TYPE_SIGNATURE) {
+            ret = ndb_append_string(&it, type, argv[i]);
+        } else {
+            char *s = dbus_signature_iter_get_signature(&sig);
+            ndb_set_error(ndb, "parameter %d has type '%s', which needs qndb", i + 1, s);
+            dbus_free(s);
+            dbus_message_unref(msg);
+            return NULL;
+        }
+        if (ret != 0) {
+            ndb_set_error(ndb, "unable to convert parameter %d", i + 1);
+            dbus_message_unref(msg);
+            return NULL;
+        }
+    }
+    return ndb_send(ndb, msg);
+}
+
+int ndb_reply_args(ndb_conn *ndb, DBusMessage *reply, int first_type, ...) {
+    if (!reply) {
+        return -1;
+    }
+    DBusError err;
+    dbus_error_init(&err);
+    va_list ap;
+    va_start(ap, first_type);
+    dbus_bool_t ok = dbus_message_get_args_valist(reply, &err, first_type, ap);
+    va_end(ap);
+    if (!ok) {
+        ndb_set_dbus_error(ndb, &err);
+        return -1;
+    }
+    return 0;
+}
+
+void ndb_reply_free(DBusMessage *reply) {
+    if (reply) {
+        dbus_message_unref(reply);
+    }
+}
+
+int ndb_subscribe(ndb_conn *ndb, const char *signal) {
+    ndb->failed = 0;
+    if (!ndb->conn) {
+        ndb_set_error(ndb, "not connected");
+        return -1;
+    }
+    if (signal && ndb->nsignals == NDB_MAX_SIGNALS) {
+        ndb_set_error(ndb, "too many signals");
+        return -1;
+    }
+    // Peers are sent every signal, without match rules
+    if (ndb->dest) {
+        char rule[256];
+        DBusError err;
+        dbus_error_init(&err);
+        int n = snprintf(rule, sizeof(rule), "type='signal',sender='%s',path='%s',interface='%s'", NDB_SERVICE, NDB_PATH, NDB_INTERFACE);
+        if (signal) {
+            snprintf(rule + n, sizeof(rule) - n, ",member='%s'", signal);
+        }
+        dbus_bus_add_match(ndb->conn, rule, &err);
+        if (dbus_error_is_set(&err)) {
+            ndb_set_dbus_error(ndb, &err);
+            return -1;
+        }
+    }
+    if (signal) {
+        ndb->signals[ndb->nsignals++] = strdup(signal);
+    } else {
+        ndb->all_signals = 1;
+    }
+    return 0;
+}
+
+static int ndb_subscribed(ndb_conn *ndb, DBusMessage *msg) {
+    if (dbus_message_get_type(msg) != DBUS_MESSAGE_TYPE_SIGNAL || !dbus_message_has_interface(msg, NDB_INTERFACE)) {
+        return 0;
+    }
+    if (ndb->all_signals) {
+        return 1;
+    }
+    for (int i = 0; i < ndb->nsignals; ++i) {
+        if (ndb->signals[i] && dbus_message_has_member(msg, ndb->signals[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static long long ndb_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+DBusMessage *ndb_wait_signal(ndb_conn *ndb, int timeout_ms) {
+    ndb->failed = 0;
+    if (!ndb->conn) {
+        ndb_set_error(ndb, "not connected");
+        return NULL;
+    }
+    long long deadline = ndb_now_ms() + timeout_ms;
+    for (;;) {
+        // Signals may already have been queued while waiting for a reply
+        DBusMessage *msg;
+        while ((msg = dbus_connection_pop_message(ndb->conn))) {
+            if (ndb_subscribed(ndb, msg)) {
+                return msg;
+            }
+            dbus_message_unref(msg);
+        }
+        int wait = -1;
+        if (timeout_ms >= 0) {
+            long long left = deadline - ndb_now_ms();
+            if (left <= 0) {
+                ndb_set_error(ndb, "timeout expired after %d milliseconds", timeout_ms);
+                return NULL;
+            }
+            wait = left;
+        }
+        if (!dbus_connection_read_write(ndb->conn, wait)) {
+            ndb_set_error(ndb, "disconnected from NickelDBus");
+            return NULL;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef NDB_CLIENT_H
+#define NDB_CLIENT_H
+
+/*
+ * A small NickelDBus client in plain C, using libdbus directly. It needs no
+ * Qt, so a program using it starts in a few milliseconds, instead of the
+ * hundreds qndb spends on loading Qt before it sends anything.
+ *
+ * Every method whose arguments are basic types has a typed function in
+ * ndb_methods.h, generated from the interface description, such as
+ *
+ *     ndb_mwcToast(ndb, 3000, "Hello World", "");
+ *
+ * Any method can also be called with its arguments as strings, the way qndb
+ * takes them, with ndb_call_strings(). Functions returning int return 0 on
+ * success, and -1 on failure, with the reason in ndb_error(). Strings
+ * returned through typed functions must be freed.
+ */
+
+#include <stdint.h>
+#include <dbus/dbus.h>
+
+#define NDB_SERVICE "com.github.shermp.nickeldbus"
+#define NDB_PATH "/nickeldbus"
+#define NDB_INTERFACE "com.github.shermp.nickeldbus"
+#define NDB_PEER_ADDRESS "unix:path=/tmp/nickeldbus-peer"
+
+typedef struct ndb_conn ndb_conn;
+
+/*
+ * Connect to NickelDBus through the system bus, or directly if peer is set
+ * (see ndbPeerListen). Returns NULL if out of memory. Check ndb_error() to
+ * find out whether the connection succeeded.
+ */
+ndb_conn *ndb_open(int peer);
+void ndb_close(ndb_conn *ndb);
+/* The last error, or NULL if the last call succeeded */
+const char *ndb_error(ndb_conn *ndb);
+/* Reply timeout for method calls, in ms. There is none by default, as some
+ * methods only reply once the user has answered a dialog. */
+void ndb_set_timeout(ndb_conn *ndb, int timeout_ms);
+
+/*
+ * Call method with arguments as for dbus_message_append_args(). Returns the
+ * reply, to be read with ndb_reply_args() and freed with ndb_reply_free(),
+ * or NULL on failure.
+ */
+DBusMessage *ndb_call(ndb_conn *ndb, const char *method, int first_type, ...);
+/*
+ * Call method with argc arguments given as strings, converted to the types
+ * the method takes. Lists of strings are given one item per line.
+ */
+DBusMessage *ndb_call_strings(ndb_conn *ndb, const char *method, int argc, char *const *argv);
+/* Read the reply, as for dbus_message_get_args(). reply may be NULL. */
+int ndb_reply_args(ndb_conn *ndb, DBusMessage *reply, int first_type, ...);
+void ndb_reply_free(DBusMessage *reply);
+
+/*
+ * Subscribe to signal, or to every signal if it is NULL. Each subscription
+ * only matches its own signal, so that the others don't wake the client.
+ * Subscribe before calling the method that leads to the signal, so that it
+ * can't be missed.
+ */
+int ndb_subscribe(ndb_conn *ndb, const char *signal);
+/*
+ * Wait for the next subscribed signal, for up to timeout_ms, or forever if
+ * it is negative. Returns the signal, to be freed with ndb_reply_free(), or
+ * NULL on timeout or disconnection.
+ */
+DBusMessage *ndb_wait_signal(ndb_conn *ndb, int timeout_ms);
+
+#include "ndb_methods.h"
+
+#endif // NDB_CLIENT_H
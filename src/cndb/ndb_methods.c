@@ -0,0 +1,756 @@
+// Generated by script/make-c-client.sh from com.github.shermp.nickeldbus.xml. Do not edit.
+#include <string.h>
+#include <unistd.h>
+#include "ndb_client.h"
+
+const struct ndb_method ndb_methods[] = {
+    {"bwmOpenBrowser", 0, ""},
+    {"bwmOpenBrowser", 1, "b"},
+    {"bwmOpenBrowser", 2, "bs"},
+    {"bwmOpenBrowser", 3, "bss"},
+    {"dlgClose", 1, "i"},
+    {"dlgConfirmAccept", 3, "sss"},
+    {"dlgConfirmAcceptReject", 4, "ssss"},
+    {"dlgConfirmClose", 0, ""},
+    {"dlgConfirmCreate", 0, ""},
+    {"dlgConfirmCreate", 1, "b"},
+    {"dlgConfirmForm", 1, "s"},
+    {"dlgConfirmNoBtn", 2, "ss"},
+    {"dlgConfirmProgressPipe", 1, "b"},
+    {"dlgConfirmReject", 3, "sss"},
+    {"dlgConfirmSetAccept", 1, "s"},
+    {"dlgConfirmSetBody", 1, "s"},
+    {"dlgConfirmSetLEPassword", 1, "b"},
+    {"dlgConfirmSetLEPlaceholder", 1, "s"},
+    {"dlgConfirmSetModal", 1, "b"},
+    {"dlgConfirmSetProgress", 3, "iii"},
+    {"dlgConfirmSetProgress", 4, "iiis"},
+    {"dlgConfirmSetReject", 1, "s"},
+    {"dlgConfirmSetTitle", 1, "s"},
+    {"dlgConfirmShow", 0, ""},
+    {"dlgConfirmShowClose", 1, "b"},
+    {"dlgCreate", 0, ""},
+    {"dlgCreate", 1, "b"},
+    {"dlgCreate", 2, "bi"},
+    {"dlgProgressPipe", 2, "ib"},
+    {"dlgPromptConfirm", 5, "ssssi"},
+    {"dlgPromptPassword", 3, "ssi"},
+    {"dlgPromptText", 3, "ssi"},
+    {"dlgSetAccept", 2, "is"},
+    {"dlgSetBody", 2, "is"},
+    {"dlgSetLEPassword", 2, "ib"},
+    {"dlgSetLEPlaceholder", 2, "is"},
+    {"dlgSetModal", 2, "ib"},
+    {"dlgSetProgress", 4, "iiii"},
+    {"dlgSetProgress", 5, "iiiis"},
+    {"dlgSetReject", 2, "is"},
+    {"dlgSetTitle", 2, "is"},
+    {"dlgShow", 1, "i"},
+    {"dlgShowClose", 2, "ib"},
+    {"imgSizeForType", 1, "s"},
+    {"mwcHome", 0, ""},
+    {"mwcToast", 2, "is"},
+    {"mwcToast", 3, "iss"},
+    {"mwcToastReplace", 3, "sis"},
+    {"mwcToastReplace", 4, "siss"},
+    {"n3fssSyncBoth", 0, ""},
+    {"n3fssSyncOnboard", 0, ""},
+    {"n3fssSyncSD", 0, ""},
+    {"ndbCapabilities", 0, ""},
+    {"ndbCurrentView", 0, ""},
+    {"ndbEventsSince", 2, "ti"},
+    {"ndbFirmwareVersion", 0, ""},
+    {"ndbNickelClassDetails", 1, "s"},
+    {"ndbNickelWidgets", 0, ""},
+    {"ndbPeerListen", 1, "b"},
+    {"ndbSignalConnected", 1, "s"},
+    {"ndbUsbmsActive", 0, ""},
+    {"ndbUsbmsDefer", 2, "bi"},
+    {"ndbVersion", 0, ""},
+    {"ndbWaitFor", 3, "ssi"},
+    {"ndbWifiKeepalive", 1, "b"},
+    {"ndbWifiKeepaliveAcquire", 1, "i"},
+    {"ndbWifiKeepaliveRelease", 1, "i"},
+    {"ndbWifiKeepaliveRenew", 2, "ii"},
+    {"nmAction", 2, "ss"},
+    {"nmChain", 2, "asb"},
+    {"nsApply", 1, "as"},
+    {"nsAutoUSBGadget", 1, "s"},
+    {"nsDarkMode", 1, "s"},
+    {"nsForceWifi", 1, "s"},
+    {"nsInvert", 1, "s"},
+    {"nsLockscreen", 1, "s"},
+    {"nsScreenshots", 1, "s"},
+    {"pfmRescanBooks", 0, ""},
+    {"pfmRescanBooksFull", 0, ""},
+    {"pwrReboot", 0, ""},
+    {"pwrShutdown", 0, ""},
+    {"pwrSleep", 0, ""},
+    {"wfmConnectWireless", 0, ""},
+    {"wfmConnectWirelessSilently", 0, ""},
+    {"wfmSetAirplaneMode", 1, "s"},
+    {"wmState", 0, ""},
+};
+
+const int ndb_method_count = sizeof(ndb_methods) / sizeof(ndb_methods[0]);
+
+int ndb_bwmOpenBrowser_0(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "bwmOpenBrowser", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_bwmOpenBrowser_1(ndb_conn *ndb, int modal) {
+    dbus_bool_t modal_b = modal;
+    DBusMessage *reply = ndb_call(ndb, "bwmOpenBrowser", DBUS_TYPE_BOOLEAN, &modal_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_bwmOpenBrowser_2(ndb_conn *ndb, int modal, const char *url) {
+    dbus_bool_t modal_b = modal;
+    DBusMessage *reply = ndb_call(ndb, "bwmOpenBrowser", DBUS_TYPE_BOOLEAN, &modal_b, DBUS_TYPE_STRING, &url, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_bwmOpenBrowser(ndb_conn *ndb, int modal, const char *url, const char *css) {
+    dbus_bool_t modal_b = modal;
+    DBusMessage *reply = ndb_call(ndb, "bwmOpenBrowser", DBUS_TYPE_BOOLEAN, &modal_b, DBUS_TYPE_STRING, &url, DBUS_TYPE_STRING, &css, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgClose(ndb_conn *ndb, int32_t handle) {
+    DBusMessage *reply = ndb_call(ndb, "dlgClose", DBUS_TYPE_INT32, &handle, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmAccept(ndb_conn *ndb, const char *title, const char *body, const char *acceptText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmAccept", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &body, DBUS_TYPE_STRING, &acceptText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmAcceptReject(ndb_conn *ndb, const char *title, const char *body, const char *acceptText, const char *rejectText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmAcceptReject", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &body, DBUS_TYPE_STRING, &acceptText, DBUS_TYPE_STRING, &rejectText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmClose(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmClose", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmCreate_0(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmCreate", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmCreate(ndb_conn *ndb, int createLineEdit) {
+    dbus_bool_t createLineEdit_b = createLineEdit;
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmCreate", DBUS_TYPE_BOOLEAN, &createLineEdit_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmForm(ndb_conn *ndb, const char *form, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmForm", DBUS_TYPE_STRING, &form, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmNoBtn(ndb_conn *ndb, const char *title, const char *body) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmNoBtn", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &body, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmProgressPipe(ndb_conn *ndb, int closeOnEof, int *ret) {
+    int ret_r;
+    dbus_bool_t closeOnEof_b = closeOnEof;
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmProgressPipe", DBUS_TYPE_BOOLEAN, &closeOnEof_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_UNIX_FD, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; } else { close(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmReject(ndb_conn *ndb, const char *title, const char *body, const char *rejectText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmReject", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &body, DBUS_TYPE_STRING, &rejectText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetAccept(ndb_conn *ndb, const char *acceptText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetAccept", DBUS_TYPE_STRING, &acceptText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetBody(ndb_conn *ndb, const char *body) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetBody", DBUS_TYPE_STRING, &body, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetLEPassword(ndb_conn *ndb, int password) {
+    dbus_bool_t password_b = password;
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetLEPassword", DBUS_TYPE_BOOLEAN, &password_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetLEPlaceholder(ndb_conn *ndb, const char *placeholder) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetLEPlaceholder", DBUS_TYPE_STRING, &placeholder, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetModal(ndb_conn *ndb, int modal) {
+    dbus_bool_t modal_b = modal;
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetModal", DBUS_TYPE_BOOLEAN, &modal_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetProgress_3(ndb_conn *ndb, int32_t min, int32_t max, int32_t val) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetProgress", DBUS_TYPE_INT32, &min, DBUS_TYPE_INT32, &max, DBUS_TYPE_INT32, &val, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetProgress(ndb_conn *ndb, int32_t min, int32_t max, int32_t val, const char *format) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetProgress", DBUS_TYPE_INT32, &min, DBUS_TYPE_INT32, &max, DBUS_TYPE_INT32, &val, DBUS_TYPE_STRING, &format, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetReject(ndb_conn *ndb, const char *rejectText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetReject", DBUS_TYPE_STRING, &rejectText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmSetTitle(ndb_conn *ndb, const char *title) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmSetTitle", DBUS_TYPE_STRING, &title, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmShow(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmShow", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgConfirmShowClose(ndb_conn *ndb, int show) {
+    dbus_bool_t show_b = show;
+    DBusMessage *reply = ndb_call(ndb, "dlgConfirmShowClose", DBUS_TYPE_BOOLEAN, &show_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgCreate_0(ndb_conn *ndb, int32_t *ret) {
+    dbus_int32_t ret_r;
+    DBusMessage *reply = ndb_call(ndb, "dlgCreate", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgCreate_1(ndb_conn *ndb, int createLineEdit, int32_t *ret) {
+    dbus_int32_t ret_r;
+    dbus_bool_t createLineEdit_b = createLineEdit;
+    DBusMessage *reply = ndb_call(ndb, "dlgCreate", DBUS_TYPE_BOOLEAN, &createLineEdit_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgCreate(ndb_conn *ndb, int createLineEdit, int32_t priority, int32_t *ret) {
+    dbus_int32_t ret_r;
+    dbus_bool_t createLineEdit_b = createLineEdit;
+    DBusMessage *reply = ndb_call(ndb, "dlgCreate", DBUS_TYPE_BOOLEAN, &createLineEdit_b, DBUS_TYPE_INT32, &priority, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgProgressPipe(ndb_conn *ndb, int32_t handle, int closeOnEof, int *ret) {
+    int ret_r;
+    dbus_bool_t closeOnEof_b = closeOnEof;
+    DBusMessage *reply = ndb_call(ndb, "dlgProgressPipe", DBUS_TYPE_INT32, &handle, DBUS_TYPE_BOOLEAN, &closeOnEof_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_UNIX_FD, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; } else { close(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgPromptConfirm(ndb_conn *ndb, const char *title, const char *body, const char *acceptText, const char *rejectText, int32_t timeout, int32_t *ret) {
+    dbus_int32_t ret_r;
+    DBusMessage *reply = ndb_call(ndb, "dlgPromptConfirm", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &body, DBUS_TYPE_STRING, &acceptText, DBUS_TYPE_STRING, &rejectText, DBUS_TYPE_INT32, &timeout, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgPromptPassword(ndb_conn *ndb, const char *title, const char *placeholder, int32_t timeout, int32_t *ret, char **text) {
+    dbus_int32_t ret_r;
+    const char *text_r;
+    DBusMessage *reply = ndb_call(ndb, "dlgPromptPassword", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &placeholder, DBUS_TYPE_INT32, &timeout, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_STRING, &text_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+        if (text) { *text = strdup(text_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgPromptText(ndb_conn *ndb, const char *title, const char *placeholder, int32_t timeout, int32_t *ret, char **text) {
+    dbus_int32_t ret_r;
+    const char *text_r;
+    DBusMessage *reply = ndb_call(ndb, "dlgPromptText", DBUS_TYPE_STRING, &title, DBUS_TYPE_STRING, &placeholder, DBUS_TYPE_INT32, &timeout, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_STRING, &text_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+        if (text) { *text = strdup(text_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetAccept(ndb_conn *ndb, int32_t handle, const char *acceptText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetAccept", DBUS_TYPE_INT32, &handle, DBUS_TYPE_STRING, &acceptText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetBody(ndb_conn *ndb, int32_t handle, const char *body) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetBody", DBUS_TYPE_INT32, &handle, DBUS_TYPE_STRING, &body, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetLEPassword(ndb_conn *ndb, int32_t handle, int password) {
+    dbus_bool_t password_b = password;
+    DBusMessage *reply = ndb_call(ndb, "dlgSetLEPassword", DBUS_TYPE_INT32, &handle, DBUS_TYPE_BOOLEAN, &password_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetLEPlaceholder(ndb_conn *ndb, int32_t handle, const char *placeholder) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetLEPlaceholder", DBUS_TYPE_INT32, &handle, DBUS_TYPE_STRING, &placeholder, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetModal(ndb_conn *ndb, int32_t handle, int modal) {
+    dbus_bool_t modal_b = modal;
+    DBusMessage *reply = ndb_call(ndb, "dlgSetModal", DBUS_TYPE_INT32, &handle, DBUS_TYPE_BOOLEAN, &modal_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetProgress_4(ndb_conn *ndb, int32_t handle, int32_t min, int32_t max, int32_t val) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetProgress", DBUS_TYPE_INT32, &handle, DBUS_TYPE_INT32, &min, DBUS_TYPE_INT32, &max, DBUS_TYPE_INT32, &val, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetProgress(ndb_conn *ndb, int32_t handle, int32_t min, int32_t max, int32_t val, const char *format) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetProgress", DBUS_TYPE_INT32, &handle, DBUS_TYPE_INT32, &min, DBUS_TYPE_INT32, &max, DBUS_TYPE_INT32, &val, DBUS_TYPE_STRING, &format, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetReject(ndb_conn *ndb, int32_t handle, const char *rejectText) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetReject", DBUS_TYPE_INT32, &handle, DBUS_TYPE_STRING, &rejectText, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgSetTitle(ndb_conn *ndb, int32_t handle, const char *title) {
+    DBusMessage *reply = ndb_call(ndb, "dlgSetTitle", DBUS_TYPE_INT32, &handle, DBUS_TYPE_STRING, &title, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgShow(ndb_conn *ndb, int32_t handle) {
+    DBusMessage *reply = ndb_call(ndb, "dlgShow", DBUS_TYPE_INT32, &handle, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_dlgShowClose(ndb_conn *ndb, int32_t handle, int show) {
+    dbus_bool_t show_b = show;
+    DBusMessage *reply = ndb_call(ndb, "dlgShowClose", DBUS_TYPE_INT32, &handle, DBUS_TYPE_BOOLEAN, &show_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_imgSizeForType(ndb_conn *ndb, const char *type, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "imgSizeForType", DBUS_TYPE_STRING, &type, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_mwcHome(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "mwcHome", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_mwcToast_2(ndb_conn *ndb, int32_t toastDuration, const char *msgMain) {
+    DBusMessage *reply = ndb_call(ndb, "mwcToast", DBUS_TYPE_INT32, &toastDuration, DBUS_TYPE_STRING, &msgMain, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_mwcToast(ndb_conn *ndb, int32_t toastDuration, const char *msgMain, const char *msgSub) {
+    DBusMessage *reply = ndb_call(ndb, "mwcToast", DBUS_TYPE_INT32, &toastDuration, DBUS_TYPE_STRING, &msgMain, DBUS_TYPE_STRING, &msgSub, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_mwcToastReplace_3(ndb_conn *ndb, const char *key, int32_t toastDuration, const char *msgMain) {
+    DBusMessage *reply = ndb_call(ndb, "mwcToastReplace", DBUS_TYPE_STRING, &key, DBUS_TYPE_INT32, &toastDuration, DBUS_TYPE_STRING, &msgMain, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_mwcToastReplace(ndb_conn *ndb, const char *key, int32_t toastDuration, const char *msgMain, const char *msgSub) {
+    DBusMessage *reply = ndb_call(ndb, "mwcToastReplace", DBUS_TYPE_STRING, &key, DBUS_TYPE_INT32, &toastDuration, DBUS_TYPE_STRING, &msgMain, DBUS_TYPE_STRING, &msgSub, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_n3fssSyncBoth(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "n3fssSyncBoth", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_n3fssSyncOnboard(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "n3fssSyncOnboard", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_n3fssSyncSD(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "n3fssSyncSD", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbCurrentView(ndb_conn *ndb, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbCurrentView", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbFirmwareVersion(ndb_conn *ndb, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbFirmwareVersion", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbNickelClassDetails(ndb_conn *ndb, const char *staticMmetaobjectSymbol, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbNickelClassDetails", DBUS_TYPE_STRING, &staticMmetaobjectSymbol, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbNickelWidgets(ndb_conn *ndb, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbNickelWidgets", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbPeerListen(ndb_conn *ndb, int listen, char **ret) {
+    const char *ret_r;
+    dbus_bool_t listen_b = listen;
+    DBusMessage *reply = ndb_call(ndb, "ndbPeerListen", DBUS_TYPE_BOOLEAN, &listen_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbSignalConnected(ndb_conn *ndb, const char *signalName, int *ret) {
+    dbus_bool_t ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbSignalConnected", DBUS_TYPE_STRING, &signalName, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_BOOLEAN, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbUsbmsActive(ndb_conn *ndb, int *ret) {
+    dbus_bool_t ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbUsbmsActive", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_BOOLEAN, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbUsbmsDefer(ndb_conn *ndb, int defer, int32_t expiry) {
+    dbus_bool_t defer_b = defer;
+    DBusMessage *reply = ndb_call(ndb, "ndbUsbmsDefer", DBUS_TYPE_BOOLEAN, &defer_b, DBUS_TYPE_INT32, &expiry, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbVersion(ndb_conn *ndb, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbVersion", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbWifiKeepalive(ndb_conn *ndb, int keepalive) {
+    dbus_bool_t keepalive_b = keepalive;
+    DBusMessage *reply = ndb_call(ndb, "ndbWifiKeepalive", DBUS_TYPE_BOOLEAN, &keepalive_b, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbWifiKeepaliveAcquire(ndb_conn *ndb, int32_t expiry, int32_t *ret) {
+    dbus_int32_t ret_r;
+    DBusMessage *reply = ndb_call(ndb, "ndbWifiKeepaliveAcquire", DBUS_TYPE_INT32, &expiry, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INT32, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = ret_r; }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbWifiKeepaliveRelease(ndb_conn *ndb, int32_t lease) {
+    DBusMessage *reply = ndb_call(ndb, "ndbWifiKeepaliveRelease", DBUS_TYPE_INT32, &lease, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_ndbWifiKeepaliveRenew(ndb_conn *ndb, int32_t lease, int32_t expiry) {
+    DBusMessage *reply = ndb_call(ndb, "ndbWifiKeepaliveRenew", DBUS_TYPE_INT32, &lease, DBUS_TYPE_INT32, &expiry, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nmAction(ndb_conn *ndb, const char *type, const char *arg, char **ret) {
+    const char *ret_r;
+    DBusMessage *reply = ndb_call(ndb, "nmAction", DBUS_TYPE_STRING, &type, DBUS_TYPE_STRING, &arg, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_STRING, &ret_r, DBUS_TYPE_INVALID);
+    if (r == 0) {
+        if (ret) { *ret = strdup(ret_r); }
+    }
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nsAutoUSBGadget(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "nsAutoUSBGadget", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nsDarkMode(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "nsDarkMode", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nsForceWifi(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "nsForceWifi", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nsInvert(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "nsInvert", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nsLockscreen(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "nsLockscreen", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_nsScreenshots(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "nsScreenshots", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_pfmRescanBooks(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "pfmRescanBooks", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_pfmRescanBooksFull(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "pfmRescanBooksFull", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_pwrReboot(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "pwrReboot", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_pwrShutdown(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "pwrShutdown", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_pwrSleep(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "pwrSleep", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_wfmConnectWireless(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "wfmConnectWireless", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_wfmConnectWirelessSilently(ndb_conn *ndb) {
+    DBusMessage *reply = ndb_call(ndb, "wfmConnectWirelessSilently", DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
+
+int ndb_wfmSetAirplaneMode(ndb_conn *ndb, const char *action) {
+    DBusMessage *reply = ndb_call(ndb, "wfmSetAirplaneMode", DBUS_TYPE_STRING, &action, DBUS_TYPE_INVALID);
+    int r = ndb_reply_args(ndb, reply, DBUS_TYPE_INVALID);
+    ndb_reply_free(reply);
+    return r;
+}
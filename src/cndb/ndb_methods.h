@@ -0,0 +1,101 @@
+// Generated by script/make-c-client.sh from com.github.shermp.nickeldbus.xml. Do not edit.
+#ifndef NDB_METHODS_H
+#define NDB_METHODS_H
+
+struct ndb_method {
+    const char *name;
+    int argc;
+    const char *in_sig;
+};
+
+extern const struct ndb_method ndb_methods[];
+extern const int ndb_method_count;
+
+int ndb_bwmOpenBrowser_0(ndb_conn *ndb);
+int ndb_bwmOpenBrowser_1(ndb_conn *ndb, int modal);
+int ndb_bwmOpenBrowser_2(ndb_conn *ndb, int modal, const char *url);
+int ndb_bwmOpenBrowser(ndb_conn *ndb, int modal, const char *url, const char *css);
+int ndb_dlgClose(ndb_conn *ndb, int32_t handle);
+int ndb_dlgConfirmAccept(ndb_conn *ndb, const char *title, const char *body, const char *acceptText);
+int ndb_dlgConfirmAcceptReject(ndb_conn *ndb, const char *title, const char *body, const char *acceptText, const char *rejectText);
+int ndb_dlgConfirmClose(ndb_conn *ndb);
+int ndb_dlgConfirmCreate_0(ndb_conn *ndb);
+int ndb_dlgConfirmCreate(ndb_conn *ndb, int createLineEdit);
+int ndb_dlgConfirmForm(ndb_conn *ndb, const char *form, char **ret);
+int ndb_dlgConfirmNoBtn(ndb_conn *ndb, const char *title, const char *body);
+int ndb_dlgConfirmProgressPipe(ndb_conn *ndb, int closeOnEof, int *ret);
+int ndb_dlgConfirmReject(ndb_conn *ndb, const char *title, const char *body, const char *rejectText);
+int ndb_dlgConfirmSetAccept(ndb_conn *ndb, const char *acceptText);
+int ndb_dlgConfirmSetBody(ndb_conn *ndb, const char *body);
+int ndb_dlgConfirmSetLEPassword(ndb_conn *ndb, int password);
+int ndb_dlgConfirmSetLEPlaceholder(ndb_conn *ndb, const char *placeholder);
+int ndb_dlgConfirmSetModal(ndb_conn *ndb, int modal);
+int ndb_dlgConfirmSetProgress_3(ndb_conn *ndb, int32_t min, int32_t max, int32_t val);
+int ndb_dlgConfirmSetProgress(ndb_conn *ndb, int32_t min, int32_t max, int32_t val, const char *format);
+int ndb_dlgConfirmSetReject(ndb_conn *ndb, const char *rejectText);
+int ndb_dlgConfirmSetTitle(ndb_conn *ndb, const char *title);
+int ndb_dlgConfirmShow(ndb_conn *ndb);
+int ndb_dlgConfirmShowClose(ndb_conn *ndb, int show);
+int ndb_dlgCreate_0(ndb_conn *ndb, int32_t *ret);
+int ndb_dlgCreate_1(ndb_conn *ndb, int createLineEdit, int32_t *ret);
+int ndb_dlgCreate(ndb_conn *ndb, int createLineEdit, int32_t priority, int32_t *ret);
+int ndb_dlgProgressPipe(ndb_conn *ndb, int32_t handle, int closeOnEof, int *ret);
+int ndb_dlgPromptConfirm(ndb_conn *ndb, const char *title, const char *body, const char *acceptText, const char *rejectText, int32_t timeout, int32_t *ret);
+int ndb_dlgPromptPassword(ndb_conn *ndb, const char *title, const char *placeholder, int32_t timeout, int32_t *ret, char **text);
+int ndb_dlgPromptText(ndb_conn *ndb, const char *title, const char *placeholder, int32_t timeout, int32_t *ret, char **text);
+int ndb_dlgSetAccept(ndb_conn *ndb, int32_t handle, const char *acceptText);
+int ndb_dlgSetBody(ndb_conn *ndb, int32_t handle, const char *body);
+int ndb_dlgSetLEPassword(ndb_conn *ndb, int32_t handle, int password);
+int ndb_dlgSetLEPlaceholder(ndb_conn *ndb, int32_t handle, const char *placeholder);
+int ndb_dlgSetModal(ndb_conn *ndb, int32_t handle, int modal);
+int ndb_dlgSetProgress_4(ndb_conn *ndb, int32_t handle, int32_t min, int32_t max, int32_t val);
+int ndb_dlgSetProgress(ndb_conn *ndb, int32_t handle, int32_t min, int32_t max, int32_t val, const char *format);
+int ndb_dlgSetReject(ndb_conn *ndb, int32_t handle, const char *rejectText);
+int ndb_dlgSetTitle(ndb_conn *ndb, int32_t handle, const char *title);
+int ndb_dlgShow(ndb_conn *ndb, int32_t handle);
+int ndb_dlgShowClose(ndb_conn *ndb, int32_t handle, int show);
+int ndb_imgSizeForType(ndb_conn *ndb, const char *type, char **ret);
+int ndb_mwcHome(ndb_conn *ndb);
+int ndb_mwcToast_2(ndb_conn *ndb, int32_t toastDuration, const char *msgMain);
+int ndb_mwcToast(ndb_conn *ndb, int32_t toastDuration, const char *msgMain, const char *msgSub);
+int ndb_mwcToastReplace_3(ndb_conn *ndb, const char *key, int32_t toastDuration, const char *msgMain);
+int ndb_mwcToastReplace(ndb_conn *ndb, const char *key, int32_t toastDuration, const char *msgMain, const char *msgSub);
+int ndb_n3fssSyncBoth(ndb_conn *ndb);
+int ndb_n3fssSyncOnboard(ndb_conn *ndb);
+int ndb_n3fssSyncSD(ndb_conn *ndb);
+// ndbCapabilities (0 arguments) uses container types, call it with ndb_call_strings()
+int ndb_ndbCurrentView(ndb_conn *ndb, char **ret);
+// ndbEventsSince (2 arguments) uses container types, call it with ndb_call_strings()
+int ndb_ndbFirmwareVersion(ndb_conn *ndb, char **ret);
+int ndb_ndbNickelClassDetails(ndb_conn *ndb, const char *staticMmetaobjectSymbol, char **ret);
+int ndb_ndbNickelWidgets(ndb_conn *ndb, char **ret);
+int ndb_ndbPeerListen(ndb_conn *ndb, int listen, char **ret);
+int ndb_ndbSignalConnected(ndb_conn *ndb, const char *signalName, int *ret);
+int ndb_ndbUsbmsActive(ndb_conn *ndb, int *ret);
+int ndb_ndbUsbmsDefer(ndb_conn *ndb, int defer, int32_t expiry);
+int ndb_ndbVersion(ndb_conn *ndb, char **ret);
+// ndbWaitFor (3 arguments) uses container types, call it with ndb_call_strings()
+int ndb_ndbWifiKeepalive(ndb_conn *ndb, int keepalive);
+int ndb_ndbWifiKeepaliveAcquire(ndb_conn *ndb, int32_t expiry, int32_t *ret);
+int ndb_ndbWifiKeepaliveRelease(ndb_conn *ndb, int32_t lease);
+int ndb_ndbWifiKeepaliveRenew(ndb_conn *ndb, int32_t lease, int32_t expiry);
+int ndb_nmAction(ndb_conn *ndb, const char *type, const char *arg, char **ret);
+// nmChain (2 arguments) uses container types, call it with ndb_call_strings()
+// nsApply (1 arguments) uses container types, call it with ndb_call_strings()
+int ndb_nsAutoUSBGadget(ndb_conn *ndb, const char *action);
+int ndb_nsDarkMode(ndb_conn *ndb, const char *action);
+int ndb_nsForceWifi(ndb_conn *ndb, const char *action);
+int ndb_nsInvert(ndb_conn *ndb, const char *action);
+int ndb_nsLockscreen(ndb_conn *ndb, const char *action);
+int ndb_nsScreenshots(ndb_conn *ndb, const char *action);
+int ndb_pfmRescanBooks(ndb_conn *ndb);
+int ndb_pfmRescanBooksFull(ndb_conn *ndb);
+int ndb_pwrReboot(ndb_conn *ndb);
+int ndb_pwrShutdown(ndb_conn *ndb);
+int ndb_pwrSleep(ndb_conn *ndb);
+int ndb_wfmConnectWireless(ndb_conn *ndb);
+int ndb_wfmConnectWirelessSilently(ndb_conn *ndb);
+int ndb_wfmSetAirplaneMode(ndb_conn *ndb, const char *action);
+// wmState (0 arguments) uses container types, call it with ndb_call_strings()
+
+#endif // NDB_METHODS_H
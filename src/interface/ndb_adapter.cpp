@@ -33,6 +33,42 @@ NDBAdapter::~NDBAdapter()
     // destructor
 }
 
+QString NDBAdapter::version() const
+{
+    // get the value of property version
+    return qvariant_cast< QString >(parent()->property("version"));
+}
+
+QString NDBAdapter::firmwareVersion() const
+{
+    // get the value of property firmwareVersion
+    return qvariant_cast< QString >(parent()->property("firmwareVersion"));
+}
+
+QString NDBAdapter::currentView() const
+{
+    // get the value of property currentView
+    return qvariant_cast< QString >(parent()->property("currentView"));
+}
+
+bool NDBAdapter::usbmsActive() const
+{
+    // get the value of property usbmsActive
+    return qvariant_cast< bool >(parent()->property("usbmsActive"));
+}
+
+QString NDBAdapter::wifiState() const
+{
+    // get the value of property wifiState
+    return qvariant_cast< QString >(parent()->property("wifiState"));
+}
+
+QStringList NDBAdapter::connectedSignals() const
+{
+    // get the value of property connectedSignals
+    return qvariant_cast< QStringList >(parent()->property("connectedSignals"));
+}
+
 void NDBAdapter::bwmOpenBrowser()
 {
     // handle method call com.github.shermp.nickeldbus.bwmOpenBrowser
@@ -57,6 +93,12 @@ void NDBAdapter::bwmOpenBrowser(bool modal, const QString &url, const QString &c
     QMetaObject::invokeMethod(parent(), "bwmOpenBrowser", Q_ARG(bool, modal), Q_ARG(QString, url), Q_ARG(QString, css));
 }
 
+void NDBAdapter::dlgClose(int handle)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgClose
+    QMetaObject::invokeMethod(parent(), "dlgClose", Q_ARG(int, handle));
+}
+
 void NDBAdapter::dlgConfirmAccept(const QString &title, const QString &body, const QString &acceptText)
 {
     // handle method call com.github.shermp.nickeldbus.dlgConfirmAccept
@@ -87,12 +129,28 @@ void NDBAdapter::dlgConfirmCreate(bool createLineEdit)
     QMetaObject::invokeMethod(parent(), "dlgConfirmCreate", Q_ARG(bool, createLineEdit));
 }
 
+QString NDBAdapter::dlgConfirmForm(const QString &form)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgConfirmForm
+    QString out0;
+    QMetaObject::invokeMethod(parent(), "dlgConfirmForm", Q_RETURN_ARG(QString, out0), Q_ARG(QString, form));
+    return out0;
+}
+
 void NDBAdapter::dlgConfirmNoBtn(const QString &title, const QString &body)
 {
     // handle method call com.github.shermp.nickeldbus.dlgConfirmNoBtn
     QMetaObject::invokeMethod(parent(), "dlgConfirmNoBtn", Q_ARG(QString, title), Q_ARG(QString, body));
 }
 
+QDBusUnixFileDescriptor NDBAdapter::dlgConfirmProgressPipe(bool closeOnEof)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgConfirmProgressPipe
+    QDBusUnixFileDescriptor out0;
+    QMetaObject::invokeMethod(parent(), "dlgConfirmProgressPipe", Q_RETURN_ARG(QDBusUnixFileDescriptor, out0), Q_ARG(bool, closeOnEof));
+    return out0;
+}
+
 void NDBAdapter::dlgConfirmReject(const QString &title, const QString &body, const QString &rejectText)
 {
     // handle method call com.github.shermp.nickeldbus.dlgConfirmReject
@@ -165,6 +223,128 @@ void NDBAdapter::dlgConfirmShowClose(bool show)
     QMetaObject::invokeMethod(parent(), "dlgConfirmShowClose", Q_ARG(bool, show));
 }
 
+int NDBAdapter::dlgCreate()
+{
+    // handle method call com.github.shermp.nickeldbus.dlgCreate
+    int out0;
+    QMetaObject::invokeMethod(parent(), "dlgCreate", Q_RETURN_ARG(int, out0));
+    return out0;
+}
+
+int NDBAdapter::dlgCreate(bool createLineEdit)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgCreate
+    int out0;
+    QMetaObject::invokeMethod(parent(), "dlgCreate", Q_RETURN_ARG(int, out0), Q_ARG(bool, createLineEdit));
+    return out0;
+}
+
+int NDBAdapter::dlgCreate(bool createLineEdit, int priority)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgCreate
+    int out0;
+    QMetaObject::invokeMethod(parent(), "dlgCreate", Q_RETURN_ARG(int, out0), Q_ARG(bool, createLineEdit), Q_ARG(int, priority));
+    return out0;
+}
+
+QDBusUnixFileDescriptor NDBAdapter::dlgProgressPipe(int handle, bool closeOnEof)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgProgressPipe
+    QDBusUnixFileDescriptor out0;
+    QMetaObject::invokeMethod(parent(), "dlgProgressPipe", Q_RETURN_ARG(QDBusUnixFileDescriptor, out0), Q_ARG(int, handle), Q_ARG(bool, closeOnEof));
+    return out0;
+}
+
+int NDBAdapter::dlgPromptConfirm(const QString &title, const QString &body, const QString &acceptText, const QString &rejectText, int timeout)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgPromptConfirm
+    int out0;
+    QMetaObject::invokeMethod(parent(), "dlgPromptConfirm", Q_RETURN_ARG(int, out0), Q_ARG(QString, title), Q_ARG(QString, body), Q_ARG(QString, acceptText), Q_ARG(QString, rejectText), Q_ARG(int, timeout));
+    return out0;
+}
+
+int NDBAdapter::dlgPromptPassword(const QString &title, const QString &placeholder, int timeout, QString &text)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgPromptPassword
+    int out0;
+    QMetaObject::invokeMethod(parent(), "dlgPromptPassword", Q_RETURN_ARG(int, out0), Q_ARG(QString, title), Q_ARG(QString, placeholder), Q_ARG(int, timeout), Q_ARG(QString&, text));
+    return out0;
+}
+
+int NDBAdapter::dlgPromptText(const QString &title, const QString &placeholder, int timeout, QString &text)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgPromptText
+    int out0;
+    QMetaObject::invokeMethod(parent(), "dlgPromptText", Q_RETURN_ARG(int, out0), Q_ARG(QString, title), Q_ARG(QString, placeholder), Q_ARG(int, timeout), Q_ARG(QString&, text));
+    return out0;
+}
+
+void NDBAdapter::dlgSetAccept(int handle, const QString &acceptText)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetAccept
+    QMetaObject::invokeMethod(parent(), "dlgSetAccept", Q_ARG(int, handle), Q_ARG(QString, acceptText));
+}
+
+void NDBAdapter::dlgSetBody(int handle, const QString &body)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetBody
+    QMetaObject::invokeMethod(parent(), "dlgSetBody", Q_ARG(int, handle), Q_ARG(QString, body));
+}
+
+void NDBAdapter::dlgSetLEPassword(int handle, bool password)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetLEPassword
+    QMetaObject::invokeMethod(parent(), "dlgSetLEPassword", Q_ARG(int, handle), Q_ARG(bool, password));
+}
+
+void NDBAdapter::dlgSetLEPlaceholder(int handle, const QString &placeholder)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetLEPlaceholder
+    QMetaObject::invokeMethod(parent(), "dlgSetLEPlaceholder", Q_ARG(int, handle), Q_ARG(QString, placeholder));
+}
+
+void NDBAdapter::dlgSetModal(int handle, bool modal)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetModal
+    QMetaObject::invokeMethod(parent(), "dlgSetModal", Q_ARG(int, handle), Q_ARG(bool, modal));
+}
+
+void NDBAdapter::dlgSetProgress(int handle, int min, int max, int val)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetProgress
+    QMetaObject::invokeMethod(parent(), "dlgSetProgress", Q_ARG(int, handle), Q_ARG(int, min), Q_ARG(int, max), Q_ARG(int, val));
+}
+
+void NDBAdapter::dlgSetProgress(int handle, int min, int max, int val, const QString &format)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetProgress
+    QMetaObject::invokeMethod(parent(), "dlgSetProgress", Q_ARG(int, handle), Q_ARG(int, min), Q_ARG(int, max), Q_ARG(int, val), Q_ARG(QString, format));
+}
+
+void NDBAdapter::dlgSetReject(int handle, const QString &rejectText)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetReject
+    QMetaObject::invokeMethod(parent(), "dlgSetReject", Q_ARG(int, handle), Q_ARG(QString, rejectText));
+}
+
+void NDBAdapter::dlgSetTitle(int handle, const QString &title)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgSetTitle
+    QMetaObject::invokeMethod(parent(), "dlgSetTitle", Q_ARG(int, handle), Q_ARG(QString, title));
+}
+
+void NDBAdapter::dlgShow(int handle)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgShow
+    QMetaObject::invokeMethod(parent(), "dlgShow", Q_ARG(int, handle));
+}
+
+void NDBAdapter::dlgShowClose(int handle, bool show)
+{
+    // handle method call com.github.shermp.nickeldbus.dlgShowClose
+    QMetaObject::invokeMethod(parent(), "dlgShowClose", Q_ARG(int, handle), Q_ARG(bool, show));
+}
+
 QString NDBAdapter::imgSizeForType(const QString &type)
 {
     // handle method call com.github.shermp.nickeldbus.imgSizeForType
@@ -191,6 +371,18 @@ void NDBAdapter::mwcToast(int toastDuration, const QString &msgMain, const QStri
     QMetaObject::invokeMethod(parent(), "mwcToast", Q_ARG(int, toastDuration), Q_ARG(QString, msgMain), Q_ARG(QString, msgSub));
 }
 
+void NDBAdapter::mwcToastReplace(const QString &key, int toastDuration, const QString &msgMain)
+{
+    // handle method call com.github.shermp.nickeldbus.mwcToastReplace
+    QMetaObject::invokeMethod(parent(), "mwcToastReplace", Q_ARG(QString, key), Q_ARG(int, toastDuration), Q_ARG(QString, msgMain));
+}
+
+void NDBAdapter::mwcToastReplace(const QString &key, int toastDuration, const QString &msgMain, const QString &msgSub)
+{
+    // handle method call com.github.shermp.nickeldbus.mwcToastReplace
+    QMetaObject::invokeMethod(parent(), "mwcToastReplace", Q_ARG(QString, key), Q_ARG(int, toastDuration), Q_ARG(QString, msgMain), Q_ARG(QString, msgSub));
+}
+
 void NDBAdapter::n3fssSyncBoth()
 {
     // handle method call com.github.shermp.nickeldbus.n3fssSyncBoth
@@ -209,6 +401,14 @@ void NDBAdapter::n3fssSyncSD()
     QMetaObject::invokeMethod(parent(), "n3fssSyncSD");
 }
 
+QVariantMap NDBAdapter::ndbCapabilities()
+{
+    // handle method call com.github.shermp.nickeldbus.ndbCapabilities
+    QVariantMap out0;
+    QMetaObject::invokeMethod(parent(), "ndbCapabilities", Q_RETURN_ARG(QVariantMap, out0));
+    return out0;
+}
+
 QString NDBAdapter::ndbCurrentView()
 {
     // handle method call com.github.shermp.nickeldbus.ndbCurrentView
@@ -217,6 +417,14 @@ QString NDBAdapter::ndbCurrentView()
     return out0;
 }
 
+QVariantList NDBAdapter::ndbEventsSince(qulonglong seq, int max, qulonglong &latest)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbEventsSince
+    QVariantList out0;
+    QMetaObject::invokeMethod(parent(), "ndbEventsSince", Q_RETURN_ARG(QVariantList, out0), Q_ARG(qulonglong, seq), Q_ARG(int, max), Q_ARG(qulonglong&, latest));
+    return out0;
+}
+
 QString NDBAdapter::ndbFirmwareVersion()
 {
     // handle method call com.github.shermp.nickeldbus.ndbFirmwareVersion
@@ -241,6 +449,14 @@ QString NDBAdapter::ndbNickelWidgets()
     return out0;
 }
 
+QString NDBAdapter::ndbPeerListen(bool listen)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbPeerListen
+    QString out0;
+    QMetaObject::invokeMethod(parent(), "ndbPeerListen", Q_RETURN_ARG(QString, out0), Q_ARG(bool, listen));
+    return out0;
+}
+
 bool NDBAdapter::ndbSignalConnected(const QString &signalName)
 {
     // handle method call com.github.shermp.nickeldbus.ndbSignalConnected
@@ -249,6 +465,20 @@ bool NDBAdapter::ndbSignalConnected(const QString &signalName)
     return out0;
 }
 
+bool NDBAdapter::ndbUsbmsActive()
+{
+    // handle method call com.github.shermp.nickeldbus.ndbUsbmsActive
+    bool out0;
+    QMetaObject::invokeMethod(parent(), "ndbUsbmsActive", Q_RETURN_ARG(bool, out0));
+    return out0;
+}
+
+void NDBAdapter::ndbUsbmsDefer(bool defer, int expiry)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbUsbmsDefer
+    QMetaObject::invokeMethod(parent(), "ndbUsbmsDefer", Q_ARG(bool, defer), Q_ARG(int, expiry));
+}
+
 QString NDBAdapter::ndbVersion()
 {
     // handle method call com.github.shermp.nickeldbus.ndbVersion
@@ -257,12 +487,64 @@ QString NDBAdapter::ndbVersion()
     return out0;
 }
 
+QVariantMap NDBAdapter::ndbWaitFor(const QString &signalName, const QString &predicate, int timeout)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbWaitFor
+    QVariantMap out0;
+    QMetaObject::invokeMethod(parent(), "ndbWaitFor", Q_RETURN_ARG(QVariantMap, out0), Q_ARG(QString, signalName), Q_ARG(QString, predicate), Q_ARG(int, timeout));
+    return out0;
+}
+
 void NDBAdapter::ndbWifiKeepalive(bool keepalive)
 {
     // handle method call com.github.shermp.nickeldbus.ndbWifiKeepalive
     QMetaObject::invokeMethod(parent(), "ndbWifiKeepalive", Q_ARG(bool, keepalive));
 }
 
+int NDBAdapter::ndbWifiKeepaliveAcquire(int expiry)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbWifiKeepaliveAcquire
+    int out0;
+    QMetaObject::invokeMethod(parent(), "ndbWifiKeepaliveAcquire", Q_RETURN_ARG(int, out0), Q_ARG(int, expiry));
+    return out0;
+}
+
+void NDBAdapter::ndbWifiKeepaliveRelease(int lease)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbWifiKeepaliveRelease
+    QMetaObject::invokeMethod(parent(), "ndbWifiKeepaliveRelease", Q_ARG(int, lease));
+}
+
+void NDBAdapter::ndbWifiKeepaliveRenew(int lease, int expiry)
+{
+    // handle method call com.github.shermp.nickeldbus.ndbWifiKeepaliveRenew
+    QMetaObject::invokeMethod(parent(), "ndbWifiKeepaliveRenew", Q_ARG(int, lease), Q_ARG(int, expiry));
+}
+
+QString NDBAdapter::nmAction(const QString &type, const QString &arg)
+{
+    // handle method call com.github.shermp.nickeldbus.nmAction
+    QString out0;
+    QMetaObject::invokeMethod(parent(), "nmAction", Q_RETURN_ARG(QString, out0), Q_ARG(QString, type), Q_ARG(QString, arg));
+    return out0;
+}
+
+QStringList NDBAdapter::nmChain(const QStringList &actions, bool stopOnError)
+{
+    // handle method call com.github.shermp.nickeldbus.nmChain
+    QStringList out0;
+    QMetaObject::invokeMethod(parent(), "nmChain", Q_RETURN_ARG(QStringList, out0), Q_ARG(QStringList, actions), Q_ARG(bool, stopOnError));
+    return out0;
+}
+
+QStringList NDBAdapter::nsApply(const QStringList &settings)
+{
+    // handle method call com.github.shermp.nickeldbus.nsApply
+    QStringList out0;
+    QMetaObject::invokeMethod(parent(), "nsApply", Q_RETURN_ARG(QStringList, out0), Q_ARG(QStringList, settings));
+    return out0;
+}
+
 void NDBAdapter::nsAutoUSBGadget(const QString &action)
 {
     // handle method call com.github.shermp.nickeldbus.nsAutoUSBGadget
@@ -347,3 +629,11 @@ void NDBAdapter::wfmSetAirplaneMode(const QString &action)
     QMetaObject::invokeMethod(parent(), "wfmSetAirplaneMode", Q_ARG(QString, action));
 }
 
+QVariantMap NDBAdapter::wmState()
+{
+    // handle method call com.github.shermp.nickeldbus.wmState
+    QVariantMap out0;
+    QMetaObject::invokeMethod(parent(), "wmState", Q_RETURN_ARG(QVariantMap, out0));
+    return out0;
+}
+
@@ -32,12 +32,26 @@ class NDBAdapter: public QDBusAbstractAdaptor
     Q_CLASSINFO("D-Bus Interface", "com.github.shermp.nickeldbus")
     Q_CLASSINFO("D-Bus Introspection", ""
 "  <interface name=\"com.github.shermp.nickeldbus\">\n"
+"    <property access=\"read\" type=\"s\" name=\"version\"/>\n"
+"    <property access=\"read\" type=\"s\" name=\"firmwareVersion\"/>\n"
+"    <property access=\"read\" type=\"s\" name=\"currentView\"/>\n"
+"    <property access=\"read\" type=\"b\" name=\"usbmsActive\"/>\n"
+"    <property access=\"read\" type=\"s\" name=\"wifiState\"/>\n"
+"    <property access=\"read\" type=\"as\" name=\"connectedSignals\"/>\n"
 "    <signal name=\"dlgConfirmResult\">\n"
 "      <arg direction=\"out\" type=\"i\" name=\"result\"/>\n"
 "    </signal>\n"
 "    <signal name=\"dlgConfirmTextInput\">\n"
 "      <arg direction=\"out\" type=\"s\" name=\"input\"/>\n"
 "    </signal>\n"
+"    <signal name=\"dlgResult\">\n"
+"      <arg direction=\"out\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"out\" type=\"i\" name=\"result\"/>\n"
+"    </signal>\n"
+"    <signal name=\"dlgTextInput\">\n"
+"      <arg direction=\"out\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"out\" type=\"s\" name=\"input\"/>\n"
+"    </signal>\n"
 "    <signal name=\"pfmDoneProcessing\"/>\n"
 "    <signal name=\"pfmAboutToConnect\"/>\n"
 "    <signal name=\"fssFinished\"/>\n"
@@ -70,6 +84,9 @@ class NDBAdapter: public QDBusAbstractAdaptor
 "    <signal name=\"rvPageChanged\">\n"
 "      <arg direction=\"out\" type=\"i\" name=\"pageNum\"/>\n"
 "    </signal>\n"
+"    <signal name=\"ndbUsbmsStateChanged\">\n"
+"      <arg direction=\"out\" type=\"b\" name=\"active\"/>\n"
+"    </signal>\n"
 "    <method name=\"ndbVersion\">\n"
 "      <arg direction=\"out\" type=\"s\"/>\n"
 "    </method>\n"
@@ -90,6 +107,32 @@ class NDBAdapter: public QDBusAbstractAdaptor
 "      <arg direction=\"out\" type=\"b\"/>\n"
 "      <arg direction=\"in\" type=\"s\" name=\"signalName\"/>\n"
 "    </method>\n"
+"    <method name=\"ndbUsbmsActive\">\n"
+"      <arg direction=\"out\" type=\"b\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbUsbmsDefer\">\n"
+"      <arg direction=\"in\" type=\"b\" name=\"defer\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"expiry\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbPeerListen\">\n"
+"      <arg direction=\"out\" type=\"s\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"listen\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbCapabilities\">\n"
+"      <arg direction=\"out\" type=\"a{sv}\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbEventsSince\">\n"
+"      <arg direction=\"out\" type=\"av\"/>\n"
+"      <arg direction=\"in\" type=\"t\" name=\"seq\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"max\"/>\n"
+"      <arg direction=\"out\" type=\"t\" name=\"latest\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbWaitFor\">\n"
+"      <arg direction=\"out\" type=\"a{sv}\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"signalName\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"predicate\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"timeout\"/>\n"
+"    </method>\n"
 "    <method name=\"mwcToast\">\n"
 "      <arg direction=\"in\" type=\"i\" name=\"toastDuration\"/>\n"
 "      <arg direction=\"in\" type=\"s\" name=\"msgMain\"/>\n"
@@ -99,6 +142,17 @@ class NDBAdapter: public QDBusAbstractAdaptor
 "      <arg direction=\"in\" type=\"i\" name=\"toastDuration\"/>\n"
 "      <arg direction=\"in\" type=\"s\" name=\"msgMain\"/>\n"
 "    </method>\n"
+"    <method name=\"mwcToastReplace\">\n"
+"      <arg direction=\"in\" type=\"s\" name=\"key\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"toastDuration\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"msgMain\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"msgSub\"/>\n"
+"    </method>\n"
+"    <method name=\"mwcToastReplace\">\n"
+"      <arg direction=\"in\" type=\"s\" name=\"key\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"toastDuration\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"msgMain\"/>\n"
+"    </method>\n"
 "    <method name=\"mwcHome\"/>\n"
 "    <method name=\"dlgConfirmNoBtn\">\n"
 "      <arg direction=\"in\" type=\"s\" name=\"title\"/>\n"
@@ -159,8 +213,106 @@ class NDBAdapter: public QDBusAbstractAdaptor
 "    <method name=\"dlgConfirmSetLEPlaceholder\">\n"
 "      <arg direction=\"in\" type=\"s\" name=\"placeholder\"/>\n"
 "    </method>\n"
+"    <method name=\"dlgConfirmProgressPipe\">\n"
+"      <arg direction=\"out\" type=\"h\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"closeOnEof\"/>\n"
+"    </method>\n"
 "    <method name=\"dlgConfirmShow\"/>\n"
 "    <method name=\"dlgConfirmClose\"/>\n"
+"    <method name=\"dlgConfirmForm\">\n"
+"      <arg direction=\"out\" type=\"s\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"form\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgCreate\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"createLineEdit\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"priority\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgCreate\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"createLineEdit\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgCreate\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetTitle\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"title\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetBody\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"body\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetAccept\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"acceptText\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetReject\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"rejectText\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetModal\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"modal\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgShowClose\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"show\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetProgress\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"min\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"max\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"val\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"format\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetProgress\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"min\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"max\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"val\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetLEPassword\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"password\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgSetLEPlaceholder\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"placeholder\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgProgressPipe\">\n"
+"      <arg direction=\"out\" type=\"h\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"closeOnEof\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgShow\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgClose\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"handle\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgPromptConfirm\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"title\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"body\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"acceptText\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"rejectText\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"timeout\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgPromptText\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"title\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"placeholder\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"timeout\"/>\n"
+"      <arg direction=\"out\" type=\"s\" name=\"text\"/>\n"
+"    </method>\n"
+"    <method name=\"dlgPromptPassword\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"title\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"placeholder\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"timeout\"/>\n"
+"      <arg direction=\"out\" type=\"s\" name=\"text\"/>\n"
+"    </method>\n"
 "    <method name=\"pfmRescanBooks\"/>\n"
 "    <method name=\"pfmRescanBooksFull\"/>\n"
 "    <method name=\"n3fssSyncOnboard\"/>\n"
@@ -171,9 +323,23 @@ class NDBAdapter: public QDBusAbstractAdaptor
 "    <method name=\"wfmSetAirplaneMode\">\n"
 "      <arg direction=\"in\" type=\"s\" name=\"action\"/>\n"
 "    </method>\n"
+"    <method name=\"wmState\">\n"
+"      <arg direction=\"out\" type=\"a{sv}\"/>\n"
+"    </method>\n"
 "    <method name=\"ndbWifiKeepalive\">\n"
 "      <arg direction=\"in\" type=\"b\" name=\"keepalive\"/>\n"
 "    </method>\n"
+"    <method name=\"ndbWifiKeepaliveAcquire\">\n"
+"      <arg direction=\"out\" type=\"i\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"expiry\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbWifiKeepaliveRenew\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"lease\"/>\n"
+"      <arg direction=\"in\" type=\"i\" name=\"expiry\"/>\n"
+"    </method>\n"
+"    <method name=\"ndbWifiKeepaliveRelease\">\n"
+"      <arg direction=\"in\" type=\"i\" name=\"lease\"/>\n"
+"    </method>\n"
 "    <method name=\"bwmOpenBrowser\">\n"
 "      <arg direction=\"in\" type=\"b\" name=\"modal\"/>\n"
 "      <arg direction=\"in\" type=\"s\" name=\"url\"/>\n"
@@ -205,6 +371,20 @@ class NDBAdapter: public QDBusAbstractAdaptor
 "    <method name=\"nsAutoUSBGadget\">\n"
 "      <arg direction=\"in\" type=\"s\" name=\"action\"/>\n"
 "    </method>\n"
+"    <method name=\"nsApply\">\n"
+"      <arg direction=\"out\" type=\"as\"/>\n"
+"      <arg direction=\"in\" type=\"as\" name=\"settings\"/>\n"
+"    </method>\n"
+"    <method name=\"nmAction\">\n"
+"      <arg direction=\"out\" type=\"s\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"type\"/>\n"
+"      <arg direction=\"in\" type=\"s\" name=\"arg\"/>\n"
+"    </method>\n"
+"    <method name=\"nmChain\">\n"
+"      <arg direction=\"out\" type=\"as\"/>\n"
+"      <arg direction=\"in\" type=\"as\" name=\"actions\"/>\n"
+"      <arg direction=\"in\" type=\"b\" name=\"stopOnError\"/>\n"
+"    </method>\n"
 "    <method name=\"pwrShutdown\"/>\n"
 "    <method name=\"pwrReboot\"/>\n"
 "    <method name=\"pwrSleep\"/>\n"
@@ -219,17 +399,38 @@ public:
     virtual ~NDBAdapter();
 
 public: // PROPERTIES
+    Q_PROPERTY(QString version READ version)
+    QString version() const;
+
+    Q_PROPERTY(QString firmwareVersion READ firmwareVersion)
+    QString firmwareVersion() const;
+
+    Q_PROPERTY(QString currentView READ currentView)
+    QString currentView() const;
+
+    Q_PROPERTY(bool usbmsActive READ usbmsActive)
+    bool usbmsActive() const;
+
+    Q_PROPERTY(QString wifiState READ wifiState)
+    QString wifiState() const;
+
+    Q_PROPERTY(QStringList connectedSignals READ connectedSignals)
+    QStringList connectedSignals() const;
+
 public Q_SLOTS: // METHODS
     void bwmOpenBrowser();
     void bwmOpenBrowser(bool modal);
     void bwmOpenBrowser(bool modal, const QString &url);
     void bwmOpenBrowser(bool modal, const QString &url, const QString &css);
+    void dlgClose(int handle);
     void dlgConfirmAccept(const QString &title, const QString &body, const QString &acceptText);
     void dlgConfirmAcceptReject(const QString &title, const QString &body, const QString &acceptText, const QString &rejectText);
     void dlgConfirmClose();
     void dlgConfirmCreate();
     void dlgConfirmCreate(bool createLineEdit);
+    QString dlgConfirmForm(const QString &form);
     void dlgConfirmNoBtn(const QString &title, const QString &body);
+    QDBusUnixFileDescriptor dlgConfirmProgressPipe(bool closeOnEof);
     void dlgConfirmReject(const QString &title, const QString &body, const QString &rejectText);
     void dlgConfirmSetAccept(const QString &acceptText);
     void dlgConfirmSetBody(const QString &body);
@@ -242,20 +443,52 @@ public Q_SLOTS: // METHODS
     void dlgConfirmSetTitle(const QString &title);
     void dlgConfirmShow();
     void dlgConfirmShowClose(bool show);
+    int dlgCreate();
+    int dlgCreate(bool createLineEdit);
+    int dlgCreate(bool createLineEdit, int priority);
+    QDBusUnixFileDescriptor dlgProgressPipe(int handle, bool closeOnEof);
+    int dlgPromptConfirm(const QString &title, const QString &body, const QString &acceptText, const QString &rejectText, int timeout);
+    int dlgPromptPassword(const QString &title, const QString &placeholder, int timeout, QString &text);
+    int dlgPromptText(const QString &title, const QString &placeholder, int timeout, QString &text);
+    void dlgSetAccept(int handle, const QString &acceptText);
+    void dlgSetBody(int handle, const QString &body);
+    void dlgSetLEPassword(int handle, bool password);
+    void dlgSetLEPlaceholder(int handle, const QString &placeholder);
+    void dlgSetModal(int handle, bool modal);
+    void dlgSetProgress(int handle, int min, int max, int val);
+    void dlgSetProgress(int handle, int min, int max, int val, const QString &format);
+    void dlgSetReject(int handle, const QString &rejectText);
+    void dlgSetTitle(int handle, const QString &title);
+    void dlgShow(int handle);
+    void dlgShowClose(int handle, bool show);
     QString imgSizeForType(const QString &type);
     void mwcHome();
     void mwcToast(int toastDuration, const QString &msgMain);
     void mwcToast(int toastDuration, const QString &msgMain, const QString &msgSub);
+    void mwcToastReplace(const QString &key, int toastDuration, const QString &msgMain);
+    void mwcToastReplace(const QString &key, int toastDuration, const QString &msgMain, const QString &msgSub);
     void n3fssSyncBoth();
     void n3fssSyncOnboard();
     void n3fssSyncSD();
+    QVariantMap ndbCapabilities();
     QString ndbCurrentView();
+    QVariantList ndbEventsSince(qulonglong seq, int max, qulonglong &latest);
     QString ndbFirmwareVersion();
     QString ndbNickelClassDetails(const QString &staticMmetaobjectSymbol);
     QString ndbNickelWidgets();
+    QString ndbPeerListen(bool listen);
     bool ndbSignalConnected(const QString &signalName);
+    bool ndbUsbmsActive();
+    void ndbUsbmsDefer(bool defer, int expiry);
     QString ndbVersion();
+    QVariantMap ndbWaitFor(const QString &signalName, const QString &predicate, int timeout);
     void ndbWifiKeepalive(bool keepalive);
+    int ndbWifiKeepaliveAcquire(int expiry);
+    void ndbWifiKeepaliveRelease(int lease);
+    void ndbWifiKeepaliveRenew(int lease, int expiry);
+    QString nmAction(const QString &type, const QString &arg);
+    QStringList nmChain(const QStringList &actions, bool stopOnError);
+    QStringList nsApply(const QStringList &settings);
     void nsAutoUSBGadget(const QString &action);
     void nsDarkMode(const QString &action);
     void nsForceWifi(const QString &action);
@@ -270,12 +503,16 @@ public Q_SLOTS: // METHODS
     void wfmConnectWireless();
     void wfmConnectWirelessSilently();
     void wfmSetAirplaneMode(const QString &action);
+    QVariantMap wmState();
 Q_SIGNALS: // SIGNALS
     void dlgConfirmResult(int result);
     void dlgConfirmTextInput(const QString &input);
+    void dlgResult(int handle, int result);
+    void dlgTextInput(int handle, const QString &input);
     void fssFinished();
     void fssGotNumFilesToProcess(int num);
     void fssParseProgress(int progress);
+    void ndbUsbmsStateChanged(bool active);
     void ndbViewChanged(const QString &newView);
     void pfmAboutToConnect();
     void pfmDoneProcessing();
@@ -35,6 +35,30 @@ public:
 
     ~NDBProxy();
 
+    Q_PROPERTY(QString version READ version)
+    inline QString version() const
+    { return qvariant_cast< QString >(property("version")); }
+
+    Q_PROPERTY(QString firmwareVersion READ firmwareVersion)
+    inline QString firmwareVersion() const
+    { return qvariant_cast< QString >(property("firmwareVersion")); }
+
+    Q_PROPERTY(QString currentView READ currentView)
+    inline QString currentView() const
+    { return qvariant_cast< QString >(property("currentView")); }
+
+    Q_PROPERTY(bool usbmsActive READ usbmsActive)
+    inline bool usbmsActive() const
+    { return qvariant_cast< bool >(property("usbmsActive")); }
+
+    Q_PROPERTY(QString wifiState READ wifiState)
+    inline QString wifiState() const
+    { return qvariant_cast< QString >(property("wifiState")); }
+
+    Q_PROPERTY(QStringList connectedSignals READ connectedSignals)
+    inline QStringList connectedSignals() const
+    { return qvariant_cast< QStringList >(property("connectedSignals")); }
+
 public Q_SLOTS: // METHODS
     inline QDBusPendingReply<> bwmOpenBrowser()
     {
@@ -63,6 +87,13 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("bwmOpenBrowser"), argumentList);
     }
 
+    inline QDBusPendingReply<> dlgClose(int handle)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle);
+        return asyncCallWithArgumentList(QLatin1String("dlgClose"), argumentList);
+    }
+
     inline QDBusPendingReply<> dlgConfirmAccept(const QString &title, const QString &body, const QString &acceptText)
     {
         QList<QVariant> argumentList;
@@ -96,6 +127,13 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("dlgConfirmCreate"), argumentList);
     }
 
+    inline QDBusPendingReply<QString> dlgConfirmForm(const QString &form)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(form);
+        return asyncCallWithArgumentList(QLatin1String("dlgConfirmForm"), argumentList);
+    }
+
     inline QDBusPendingReply<> dlgConfirmNoBtn(const QString &title, const QString &body)
     {
         QList<QVariant> argumentList;
@@ -103,6 +141,13 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("dlgConfirmNoBtn"), argumentList);
     }
 
+    inline QDBusPendingReply<QDBusUnixFileDescriptor> dlgConfirmProgressPipe(bool closeOnEof)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(closeOnEof);
+        return asyncCallWithArgumentList(QLatin1String("dlgConfirmProgressPipe"), argumentList);
+    }
+
     inline QDBusPendingReply<> dlgConfirmReject(const QString &title, const QString &body, const QString &rejectText)
     {
         QList<QVariant> argumentList;
@@ -186,6 +231,153 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("dlgConfirmShowClose"), argumentList);
     }
 
+    inline QDBusPendingReply<int> dlgCreate()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("dlgCreate"), argumentList);
+    }
+
+    inline QDBusPendingReply<int> dlgCreate(bool createLineEdit)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(createLineEdit);
+        return asyncCallWithArgumentList(QLatin1String("dlgCreate"), argumentList);
+    }
+
+    inline QDBusPendingReply<int> dlgCreate(bool createLineEdit, int priority)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(createLineEdit) << QVariant::fromValue(priority);
+        return asyncCallWithArgumentList(QLatin1String("dlgCreate"), argumentList);
+    }
+
+    inline QDBusPendingReply<QDBusUnixFileDescriptor> dlgProgressPipe(int handle, bool closeOnEof)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(closeOnEof);
+        return asyncCallWithArgumentList(QLatin1String("dlgProgressPipe"), argumentList);
+    }
+
+    inline QDBusPendingReply<int> dlgPromptConfirm(const QString &title, const QString &body, const QString &acceptText, const QString &rejectText, int timeout)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(title) << QVariant::fromValue(body) << QVariant::fromValue(acceptText) << QVariant::fromValue(rejectText) << QVariant::fromValue(timeout);
+        return asyncCallWithArgumentList(QLatin1String("dlgPromptConfirm"), argumentList);
+    }
+
+    inline QDBusPendingReply<int, QString> dlgPromptPassword(const QString &title, const QString &placeholder, int timeout)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(title) << QVariant::fromValue(placeholder) << QVariant::fromValue(timeout);
+        return asyncCallWithArgumentList(QLatin1String("dlgPromptPassword"), argumentList);
+    }
+
+    inline QDBusReply<int> dlgPromptPassword(const QString &title, const QString &placeholder, int timeout, QString &text)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(title) << QVariant::fromValue(placeholder) << QVariant::fromValue(timeout);
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, QLatin1String("dlgPromptPassword"), argumentList);
+        if (reply.type() == QDBusMessage::ReplyMessage && reply.arguments().count() == 2) {
+            text = qdbus_cast<QString>(reply.arguments().at(1));
+        }
+        return reply;
+    }
+
+    inline QDBusPendingReply<int, QString> dlgPromptText(const QString &title, const QString &placeholder, int timeout)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(title) << QVariant::fromValue(placeholder) << QVariant::fromValue(timeout);
+        return asyncCallWithArgumentList(QLatin1String("dlgPromptText"), argumentList);
+    }
+
+    inline QDBusReply<int> dlgPromptText(const QString &title, const QString &placeholder, int timeout, QString &text)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(title) << QVariant::fromValue(placeholder) << QVariant::fromValue(timeout);
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, QLatin1String("dlgPromptText"), argumentList);
+        if (reply.type() == QDBusMessage::ReplyMessage && reply.arguments().count() == 2) {
+            text = qdbus_cast<QString>(reply.arguments().at(1));
+        }
+        return reply;
+    }
+
+    inline QDBusPendingReply<> dlgSetAccept(int handle, const QString &acceptText)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(acceptText);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetAccept"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetBody(int handle, const QString &body)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(body);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetBody"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetLEPassword(int handle, bool password)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(password);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetLEPassword"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetLEPlaceholder(int handle, const QString &placeholder)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(placeholder);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetLEPlaceholder"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetModal(int handle, bool modal)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(modal);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetModal"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetProgress(int handle, int min, int max, int val)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(min) << QVariant::fromValue(max) << QVariant::fromValue(val);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetProgress"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetProgress(int handle, int min, int max, int val, const QString &format)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(min) << QVariant::fromValue(max) << QVariant::fromValue(val) << QVariant::fromValue(format);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetProgress"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetReject(int handle, const QString &rejectText)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(rejectText);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetReject"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgSetTitle(int handle, const QString &title)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(title);
+        return asyncCallWithArgumentList(QLatin1String("dlgSetTitle"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgShow(int handle)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle);
+        return asyncCallWithArgumentList(QLatin1String("dlgShow"), argumentList);
+    }
+
+    inline QDBusPendingReply<> dlgShowClose(int handle, bool show)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(handle) << QVariant::fromValue(show);
+        return asyncCallWithArgumentList(QLatin1String("dlgShowClose"), argumentList);
+    }
+
     inline QDBusPendingReply<QString> imgSizeForType(const QString &type)
     {
         QList<QVariant> argumentList;
@@ -213,6 +405,20 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("mwcToast"), argumentList);
     }
 
+    inline QDBusPendingReply<> mwcToastReplace(const QString &key, int toastDuration, const QString &msgMain)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(key) << QVariant::fromValue(toastDuration) << QVariant::fromValue(msgMain);
+        return asyncCallWithArgumentList(QLatin1String("mwcToastReplace"), argumentList);
+    }
+
+    inline QDBusPendingReply<> mwcToastReplace(const QString &key, int toastDuration, const QString &msgMain, const QString &msgSub)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(key) << QVariant::fromValue(toastDuration) << QVariant::fromValue(msgMain) << QVariant::fromValue(msgSub);
+        return asyncCallWithArgumentList(QLatin1String("mwcToastReplace"), argumentList);
+    }
+
     inline QDBusPendingReply<> n3fssSyncBoth()
     {
         QList<QVariant> argumentList;
@@ -231,12 +437,36 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("n3fssSyncSD"), argumentList);
     }
 
+    inline QDBusPendingReply<QVariantMap> ndbCapabilities()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("ndbCapabilities"), argumentList);
+    }
+
     inline QDBusPendingReply<QString> ndbCurrentView()
     {
         QList<QVariant> argumentList;
         return asyncCallWithArgumentList(QLatin1String("ndbCurrentView"), argumentList);
     }
 
+    inline QDBusPendingReply<QVariantList, qulonglong> ndbEventsSince(qulonglong seq, int max)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(seq) << QVariant::fromValue(max);
+        return asyncCallWithArgumentList(QLatin1String("ndbEventsSince"), argumentList);
+    }
+
+    inline QDBusReply<QVariantList> ndbEventsSince(qulonglong seq, int max, qulonglong &latest)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(seq) << QVariant::fromValue(max);
+        QDBusMessage reply = callWithArgumentList(QDBus::Block, QLatin1String("ndbEventsSince"), argumentList);
+        if (reply.type() == QDBusMessage::ReplyMessage && reply.arguments().count() == 2) {
+            latest = qdbus_cast<qulonglong>(reply.arguments().at(1));
+        }
+        return reply;
+    }
+
     inline QDBusPendingReply<QString> ndbFirmwareVersion()
     {
         QList<QVariant> argumentList;
@@ -256,6 +486,13 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("ndbNickelWidgets"), argumentList);
     }
 
+    inline QDBusPendingReply<QString> ndbPeerListen(bool listen)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(listen);
+        return asyncCallWithArgumentList(QLatin1String("ndbPeerListen"), argumentList);
+    }
+
     inline QDBusPendingReply<bool> ndbSignalConnected(const QString &signalName)
     {
         QList<QVariant> argumentList;
@@ -263,12 +500,32 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("ndbSignalConnected"), argumentList);
     }
 
+    inline QDBusPendingReply<bool> ndbUsbmsActive()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("ndbUsbmsActive"), argumentList);
+    }
+
+    inline QDBusPendingReply<> ndbUsbmsDefer(bool defer, int expiry)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(defer) << QVariant::fromValue(expiry);
+        return asyncCallWithArgumentList(QLatin1String("ndbUsbmsDefer"), argumentList);
+    }
+
     inline QDBusPendingReply<QString> ndbVersion()
     {
         QList<QVariant> argumentList;
         return asyncCallWithArgumentList(QLatin1String("ndbVersion"), argumentList);
     }
 
+    inline QDBusPendingReply<QVariantMap> ndbWaitFor(const QString &signalName, const QString &predicate, int timeout)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(signalName) << QVariant::fromValue(predicate) << QVariant::fromValue(timeout);
+        return asyncCallWithArgumentList(QLatin1String("ndbWaitFor"), argumentList);
+    }
+
     inline QDBusPendingReply<> ndbWifiKeepalive(bool keepalive)
     {
         QList<QVariant> argumentList;
@@ -276,6 +533,48 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("ndbWifiKeepalive"), argumentList);
     }
 
+    inline QDBusPendingReply<int> ndbWifiKeepaliveAcquire(int expiry)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(expiry);
+        return asyncCallWithArgumentList(QLatin1String("ndbWifiKeepaliveAcquire"), argumentList);
+    }
+
+    inline QDBusPendingReply<> ndbWifiKeepaliveRelease(int lease)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(lease);
+        return asyncCallWithArgumentList(QLatin1String("ndbWifiKeepaliveRelease"), argumentList);
+    }
+
+    inline QDBusPendingReply<> ndbWifiKeepaliveRenew(int lease, int expiry)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(lease) << QVariant::fromValue(expiry);
+        return asyncCallWithArgumentList(QLatin1String("ndbWifiKeepaliveRenew"), argumentList);
+    }
+
+    inline QDBusPendingReply<QString> nmAction(const QString &type, const QString &arg)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(type) << QVariant::fromValue(arg);
+        return asyncCallWithArgumentList(QLatin1String("nmAction"), argumentList);
+    }
+
+    inline QDBusPendingReply<QStringList> nmChain(const QStringList &actions, bool stopOnError)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(actions) << QVariant::fromValue(stopOnError);
+        return asyncCallWithArgumentList(QLatin1String("nmChain"), argumentList);
+    }
+
+    inline QDBusPendingReply<QStringList> nsApply(const QStringList &settings)
+    {
+        QList<QVariant> argumentList;
+        argumentList << QVariant::fromValue(settings);
+        return asyncCallWithArgumentList(QLatin1String("nsApply"), argumentList);
+    }
+
     inline QDBusPendingReply<> nsAutoUSBGadget(const QString &action)
     {
         QList<QVariant> argumentList;
@@ -367,12 +666,21 @@ public Q_SLOTS: // METHODS
         return asyncCallWithArgumentList(QLatin1String("wfmSetAirplaneMode"), argumentList);
     }
 
+    inline QDBusPendingReply<QVariantMap> wmState()
+    {
+        QList<QVariant> argumentList;
+        return asyncCallWithArgumentList(QLatin1String("wmState"), argumentList);
+    }
+
 Q_SIGNALS: // SIGNALS
     void dlgConfirmResult(int result);
     void dlgConfirmTextInput(const QString &input);
+    void dlgResult(int handle, int result);
+    void dlgTextInput(int handle, const QString &input);
     void fssFinished();
     void fssGotNumFilesToProcess(int num);
     void fssParseProgress(int progress);
+    void ndbUsbmsStateChanged(bool active);
     void ndbViewChanged(const QString &newView);
     void pfmAboutToConnect();
     void pfmDoneProcessing();
@@ -1,6 +1,12 @@
 #include <Qt>
 #include <QLocale>
+#include <QLabel>
+#include <QRadioButton>
+#include <QVBoxLayout>
 #include <NickelHook.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "util.h"
 #include "NDBCfmDlg.h"
 
@@ -18,80 +24,180 @@
     return (ret);                                         \
 }
 
+// How long (in ms) no dialog must be open before the warm dialogs are rebuilt
+#define NDB_DLG_WARM_DELAY 2000
+
 namespace NDB {
 
 NDBCfmDlg::NDBCfmDlg(QObject* parent) : QObject(parent) {
     initResult = Ok;
     currActiveType = TypeStd;
-    dlgStyleSheet = QString(R"(
-            * {
-                font-family: Avenir, sans-serif;
-                font-style: normal;
-                padding: 0px;
-                margin: 0px;
-            }
-            *[localeName="ja"] {
-                font-family: Sans-SerifJP, sans-serif;
-                font-style: normal;
-            }
-            *[localeName="zh"] {
-                font-family: Sans-SerifZH-Simplified, sans-serif;
-                font-style: normal;
-            }
-            *[localeName="zh-HK"] {
-                font-family: Sans-SerifZH-Traditional, sans-serif;
-                font-style: normal;
-            }
-            *[localeName="zh-TW"] {
-                font-family: Sans-SerifZH-Traditional, sans-serif;
-                font-style: normal;
-            }
+    resolveSymbols();
+}
 
-            *[qApp_deviceIsTrilogy=true] {
-                font-size: 23px;
-            }
-            *[qApp_deviceIsPhoenix=true] {
-                font-size: 26px;
-            }
-            *[qApp_deviceIsDragon=true] {
-                font-size: 32px;
-            }
-            *[qApp_deviceIsAlyssum=true] {
-                font-size: 35px;
-            }
-            *[qApp_deviceIsNova=true] {
-                font-size: 35px;
-            }
-            *[qApp_deviceIsStorm=true] {
-                font-size: 44px;
-            }
-            *[qApp_deviceIsDaylight=true] {
-                font-size: 42px;
-            }
-        )");
-    
-    /* Resolve symbols */
+NDBCfmDlg::Symbols NDBCfmDlg::symbols;
+bool NDBCfmDlg::symbolsResolved = false;
+QMap<QString, bool> NDBCfmDlg::nickelSymbols;
+NDBCfmDlg::WarmDialogs NDBCfmDlg::warm;
+QTimer *NDBCfmDlg::warmTimer = nullptr;
+bool NDBCfmDlg::warmEnabled = false;
+int NDBCfmDlg::liveDialogs = 0;
+const QString NDBCfmDlg::dlgStyleSheet = QString(R"(
+        * {
+            font-family: Avenir, sans-serif;
+            font-style: normal;
+            padding: 0px;
+            margin: 0px;
+        }
+        *[localeName="ja"] {
+            font-family: Sans-SerifJP, sans-serif;
+            font-style: normal;
+        }
+        *[localeName="zh"] {
+            font-family: Sans-SerifZH-Simplified, sans-serif;
+            font-style: normal;
+        }
+        *[localeName="zh-HK"] {
+            font-family: Sans-SerifZH-Traditional, sans-serif;
+            font-style: normal;
+        }
+        *[localeName="zh-TW"] {
+            font-family: Sans-SerifZH-Traditional, sans-serif;
+            font-style: normal;
+        }
+
+        *[qApp_deviceIsTrilogy=true] {
+            font-size: 23px;
+        }
+        *[qApp_deviceIsPhoenix=true] {
+            font-size: 26px;
+        }
+        *[qApp_deviceIsDragon=true] {
+            font-size: 32px;
+        }
+        *[qApp_deviceIsAlyssum=true] {
+            font-size: 35px;
+        }
+        *[qApp_deviceIsNova=true] {
+            font-size: 35px;
+        }
+        *[qApp_deviceIsStorm=true] {
+            font-size: 44px;
+        }
+        *[qApp_deviceIsDaylight=true] {
+            font-size: 42px;
+        }
+    )");
+
+
+// Resolves a symbol, and records whether it was found for ndbCapabilities()
+#define NDB_RESOLVE_SYMBOL_RTLD(name, fn) nickelSymbols.insert(QStringLiteral(name), resolveSymbolRTLD(name, fn))
+
+void NDBCfmDlg::resolveSymbols() {
+    if (symbolsResolved) {
+        return;
+    }
+    symbolsResolved = true;
     // Confirmation Dialog
-    resolveSymbolRTLD("_ZN25ConfirmationDialogFactory21getConfirmationDialogEP7QWidget", nh_symoutptr(symbols.ConfirmationDialogFactory_getConfirmationDialog));
-    resolveSymbolRTLD("_ZN25ConfirmationDialogFactory18showTextEditDialogERK7QString", nh_symoutptr(symbols.ConfirmationDialogFactory_showTextEditDialog));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog8setTitleERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setTitle));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog7setTextERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setText));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog19setAcceptButtonTextERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setAcceptButtonText));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog19setRejectButtonTextERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setRejectButtonText));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog15showCloseButtonEb", nh_symoutptr(symbols.ConfirmationDialog__showCloseButton));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog21setRejectOnOutsideTapEb", nh_symoutptr(symbols.ConfirmationDialog__setRejectOnOutsideTap));
-    resolveSymbolRTLD("_ZN18ConfirmationDialog9addWidgetEP7QWidget", nh_symoutptr(symbols.ConfirmationDialog__addWidget));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN25ConfirmationDialogFactory21getConfirmationDialogEP7QWidget", nh_symoutptr(symbols.ConfirmationDialogFactory_getConfirmationDialog));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN25ConfirmationDialogFactory18showTextEditDialogERK7QString", nh_symoutptr(symbols.ConfirmationDialogFactory_showTextEditDialog));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog8setTitleERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setTitle));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog7setTextERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setText));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog19setAcceptButtonTextERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setAcceptButtonText));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog19setRejectButtonTextERK7QString", nh_symoutptr(symbols.ConfirmationDialog__setRejectButtonText));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog15showCloseButtonEb", nh_symoutptr(symbols.ConfirmationDialog__showCloseButton));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog21setRejectOnOutsideTapEb", nh_symoutptr(symbols.ConfirmationDialog__setRejectOnOutsideTap));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZN18ConfirmationDialog9addWidgetEP7QWidget", nh_symoutptr(symbols.ConfirmationDialog__addWidget));
 
     // Keyboard stuff
-    resolveSymbolRTLD("_ZN27N3ConfirmationTextEditFieldC1EP18ConfirmationDialog14KeyboardScript", nh_symoutptr(symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS));
-    if (!symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS) {
-        // FW 4.6 has a slightly different constructor without the KeyboardScript stuff
-        resolveSymbolRTLD("_ZN27N3ConfirmationTextEditFieldC1EP18ConfirmationDialog", nh_symoutptr(symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditField));
+    // FW 4.6 has a slightly different constructor without the KeyboardScript stuff
+    nickelSymbols.insert(QStringLiteral("_ZN27N3ConfirmationTextEditFieldC1EP18ConfirmationDialog14KeyboardScript"), 
+        resolveSymbolRTLD("_ZN27N3ConfirmationTextEditFieldC1EP18ConfirmationDialog14KeyboardScript", nh_symoutptr(symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS)) || 
+        resolveSymbolRTLD("_ZN27N3ConfirmationTextEditFieldC1EP18ConfirmationDialog", nh_symoutptr(symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditField)));
+    NDB_RESOLVE_SYMBOL_RTLD("_ZNK27N3ConfirmationTextEditField8textEditEv", nh_symoutptr(symbols.N3ConfirmationTextEditField__textEdit));
+}
+
+/*!
+ * \internal
+ * \brief Start keeping warm dialogs ready.
+ *
+ * Nickel's dialog factories need the main window, so this is only called once
+ * it has been found.
+ */
+void NDBCfmDlg::startWarming() {
+    if (warmEnabled) {
+        return;
+    }
+    warmEnabled = true;
+    scheduleWarmDialogs();
+}
+
+/*
+ * Count a dialog taken by createDialog() until it is destroyed, so the warm
+ * dialogs are only rebuilt while no dialog is open.
+ */
+void NDBCfmDlg::trackDialog(ConfirmationDialog *d) {
+    ++liveDialogs;
+    QObject::connect(d, &QObject::destroyed, &NDBCfmDlg::dialogGone);
+}
+
+void NDBCfmDlg::dialogGone() {
+    if (--liveDialogs == 0) {
+        scheduleWarmDialogs();
+    }
+}
+
+/*
+ * Build the warm dialogs once no dialog has been open for a while. Taking a
+ * dialog from the pool doesn't refill it; that waits until the last open
+ * dialog has gone away.
+ */
+void NDBCfmDlg::scheduleWarmDialogs() {
+    if (!warmEnabled) {
+        return;
+    }
+    if (!warmTimer) {
+        warmTimer = new QTimer();
+        warmTimer->setSingleShot(true);
+        warmTimer->setInterval(NDB_DLG_WARM_DELAY);
+        QObject::connect(warmTimer, &QTimer::timeout, &NDBCfmDlg::warmDialogs);
+    }
+    warmTimer->start();
+}
+
+void NDBCfmDlg::warmDialogs() {
+    if (liveDialogs > 0) {
+        return;
+    }
+    if (!warm.std && symbols.ConfirmationDialogFactory_getConfirmationDialog) {
+        NDB_DEBUG("warming standard dialog");
+        warm.std = symbols.ConfirmationDialogFactory_getConfirmationDialog(nullptr);
+    }
+    if (!warm.lineEdit && symbols.ConfirmationDialogFactory_showTextEditDialog && symbols.N3ConfirmationTextEditField__textEdit) {
+        NDB_DEBUG("warming line edit dialog");
+        ConfirmationDialog *d = symbols.ConfirmationDialogFactory_showTextEditDialog("");
+        if (d) {
+            d->hide();
+            N3ConfirmationTextEditField *t = createTextEditField(d);
+            TouchLineEdit *le = t ? symbols.N3ConfirmationTextEditField__textEdit(t) : nullptr;
+            if (le) {
+                warm.lineEdit = d;
+                warm.tef = t;
+                warm.tle = le;
+            } else {
+                d->deleteLater();
+            }
+        }
+    }
+    if (!warm.prog) {
+        warm.prog = new NDBProgressBar();
+        warm.prog->setStyleSheet(dlgStyleSheet);
+        warm.prog->ensurePolished();
     }
-    resolveSymbolRTLD("_ZNK27N3ConfirmationTextEditField8textEditEv", nh_symoutptr(symbols.N3ConfirmationTextEditField__textEdit));
 }
 
 NDBCfmDlg::~NDBCfmDlg() {
+    closeProgressPipe();
 }
 
 void NDBCfmDlg::connectStdSignals() {
@@ -106,17 +212,29 @@ void NDBCfmDlg::connectStdSignals() {
     }
 }
 
-N3ConfirmationTextEditField* NDBCfmDlg::createTextEditField() {
+N3ConfirmationTextEditField* NDBCfmDlg::createTextEditField(ConfirmationDialog *d) {
+    if (!d) {return nullptr;}
     N3ConfirmationTextEditField *t = reinterpret_cast<N3ConfirmationTextEditField*>(calloc(1,128));
-    if (!t || !dlg) {return nullptr;}
+    if (!t) {return nullptr;}
     if (symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS) {
-        symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS(t, dlg, 1);
+        symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS(t, d, 1);
     } else {
-        symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditField(t, dlg);
+        symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditField(t, d);
     }
     return t;
 }
 
+NDBProgressBar* NDBCfmDlg::createProgressBar() {
+    NDBProgressBar *p = warm.prog;
+    warm.prog = nullptr;
+    if (p) {
+        return p;
+    }
+    p = new NDBProgressBar();
+    p->setStyleSheet(dlgStyleSheet);
+    return p;
+}
+
 enum Result NDBCfmDlg::createDialog(enum dialogType dlgType) {
     DLG_ASSERT(ForbiddenError, !dlg, "dialog already open");
     DLG_ASSERT_CLOSE(
@@ -131,7 +249,7 @@ enum Result NDBCfmDlg::createDialog(enum dialogType dlgType) {
         symbols.ConfirmationDialog__showCloseButton,
         "could not find one or more standard dialog symbols"
     );
-    if (dlgType == TypeLineEdit) {
+    if (dlgType != TypeStd) {
         DLG_ASSERT_CLOSE(
             SymbolError,
             (symbols.N3ConfirmationTextEditField__N3ConfirmationTextEditFieldKS ||
@@ -141,21 +259,38 @@ enum Result NDBCfmDlg::createDialog(enum dialogType dlgType) {
         );
     }
 
+    formFields.clear();
     switch (dlgType) {
     case TypeStd:
-        dlg = symbols.ConfirmationDialogFactory_getConfirmationDialog(nullptr);
+        dlg = warm.std;
+        warm.std = nullptr;
+        if (!dlg) {
+            dlg = symbols.ConfirmationDialogFactory_getConfirmationDialog(nullptr);
+        }
         DLG_ASSERT_CLOSE(NullError, dlg, "could not get confirmation dialog");
+        trackDialog(dlg);
         currActiveType = TypeStd;
         break;
 
     case TypeLineEdit:
-        dlg = symbols.ConfirmationDialogFactory_showTextEditDialog("");
-        DLG_ASSERT_CLOSE(NullError, dlg, "could not get line edit dialog");
-        dlg->hide();
-        tef = createTextEditField();
-        DLG_ASSERT_CLOSE(NullError, tef, "error getting text edit field");
-        tle = symbols.N3ConfirmationTextEditField__textEdit(tef);
-        DLG_ASSERT_CLOSE(NullError, tle, "error getting TouchLineEdit");
+        if (warm.lineEdit && warm.tef && warm.tle) {
+            dlg = warm.lineEdit;
+            tef = warm.tef;
+            tle = warm.tle;
+            trackDialog(dlg);
+        } else {
+            dlg = symbols.ConfirmationDialogFactory_showTextEditDialog("");
+            DLG_ASSERT_CLOSE(NullError, dlg, "could not get line edit dialog");
+            trackDialog(dlg);
+            dlg->hide();
+            tef = createTextEditField(dlg);
+            DLG_ASSERT_CLOSE(NullError, tef, "error getting text edit field");
+            tle = symbols.N3ConfirmationTextEditField__textEdit(tef);
+            DLG_ASSERT_CLOSE(NullError, tle, "error getting TouchLineEdit");
+        }
+        warm.lineEdit = nullptr;
+        warm.tef = nullptr;
+        warm.tle = nullptr;
         // Make the 'Go' key accept the dialog.
         if (!QObject::connect(tef, SIGNAL(commitRequested()), dlg, SIGNAL(accepted()))) {
             nh_log("unable to connect N3ConfirmationTextEditField::commitRequested() to ConfirmationDialog::accepted()");
@@ -163,6 +298,15 @@ enum Result NDBCfmDlg::createDialog(enum dialogType dlgType) {
         currActiveType = TypeLineEdit;
         break;
 
+    case TypeForm:
+        // Text edit fields are added by createForm()
+        dlg = symbols.ConfirmationDialogFactory_showTextEditDialog("");
+        DLG_ASSERT_CLOSE(NullError, dlg, "could not get line edit dialog");
+        trackDialog(dlg);
+        dlg->hide();
+        currActiveType = TypeForm;
+        break;
+
     default:
         DLG_ASSERT(ParamError, false, "Incorrect dialog type passed");
         break;
@@ -172,6 +316,109 @@ enum Result NDBCfmDlg::createDialog(enum dialogType dlgType) {
     return Ok;
 }
 
+enum Result NDBCfmDlg::createForm(QVariantMap const& form) {
+    DLG_ASSERT(ForbiddenError, !dlg, "dialog already open");
+    QVariantList fields = form.value("fields").toList();
+    int lastLineEdit = -1;
+    for (int i = 0; i < fields.size(); ++i) {
+        if (fields[i].toMap().value("type").toString() == "lineedit") {
+            lastLineEdit = i;
+        }
+    }
+    // Forms without text fields don't need the keyboard, so use a plain dialog
+    enum Result res = createDialog(lastLineEdit >= 0 ? TypeForm : TypeStd);
+    if (res != Ok) {
+        return res;
+    }
+    currActiveType = TypeForm;
+    DLG_ASSERT_CLOSE(SymbolError, symbols.ConfirmationDialog__addWidget, "could not find addWidget symbol");
+    if (form.contains("title")) { setTitle(form.value("title").toString()); }
+    if (form.contains("accept")) { setAccept(form.value("accept").toString()); }
+    if (form.contains("reject")) { setReject(form.value("reject").toString()); }
+    for (int i = 0; i < fields.size(); ++i) {
+        res = addFormField(fields[i].toMap(), i == lastLineEdit);
+        DLG_ASSERT_CLOSE(res, res == Ok, errString);
+    }
+    return Ok;
+}
+
+enum Result NDBCfmDlg::addFormField(QVariantMap const& field, bool isLastLineEdit) {
+    FormField f;
+    f.type = field.value("type").toString();
+    f.name = field.value("name").toString();
+    QString label = field.value("label").toString();
+    DLG_ASSERT(ParamError, !f.name.isEmpty() || f.type == "label" || f.type == "progress", "form field requires a name");
+    // Check boxes carry their own label
+    if ((!label.isEmpty() && f.type != "checkbox") || f.type == "label") {
+        QLabel *l = new QLabel(f.type == "label" ? field.value("text").toString() : label);
+        l->setWordWrap(true);
+        l->setStyleSheet(dlgStyleSheet);
+        symbols.ConfirmationDialog__addWidget(dlg, l);
+    }
+    if (f.type == "label") {
+        return Ok;
+    } else if (f.type == "lineedit") {
+        // Each N3ConfirmationTextEditField adds itself to the dialog
+        N3ConfirmationTextEditField *t = createTextEditField(dlg);
+        DLG_ASSERT(NullError, t, "error getting text edit field");
+        TouchLineEdit *le = symbols.N3ConfirmationTextEditField__textEdit(t);
+        DLG_ASSERT(NullError, le, "error getting TouchLineEdit");
+        le->setText(field.value("text").toString());
+        le->setPlaceholderText(field.value("placeholder").toString());
+        TouchCheckBox *tcb = t->findChild<TouchCheckBox*>(QString("showPassword"));
+        if (tcb) {
+            bool isPassword = field.value("password").toBool();
+            tcb->setChecked(!isPassword);
+            tcb->setVisible(isPassword);
+        }
+        // Only the final text field gets to accept the form with its 'Go' key
+        if (isLastLineEdit && !QObject::connect(t, SIGNAL(commitRequested()), dlg, SIGNAL(accepted()))) {
+            nh_log("unable to connect N3ConfirmationTextEditField::commitRequested() to ConfirmationDialog::accepted()");
+        }
+        f.obj = le;
+    } else if (f.type == "checkbox") {
+        QCheckBox *cb = new QCheckBox(label);
+        cb->setChecked(field.value("checked").toBool());
+        cb->setStyleSheet(dlgStyleSheet);
+        symbols.ConfirmationDialog__addWidget(dlg, cb);
+        f.obj = cb;
+    } else if (f.type == "choice") {
+        f.options = field.value("options").toStringList();
+        DLG_ASSERT(ParamError, !f.options.isEmpty(), "choice field requires options");
+        QWidget *w = new QWidget();
+        QVBoxLayout *layout = new QVBoxLayout(w);
+        QButtonGroup *group = new QButtonGroup(w);
+        int selected = field.contains("selected") ? field.value("selected").toInt() : -1;
+        for (int i = 0; i < f.options.size(); ++i) {
+            QRadioButton *rb = new QRadioButton(f.options.at(i), w);
+            rb->setChecked(i == selected);
+            group->addButton(rb, i);
+            layout->addWidget(rb);
+        }
+        w->setStyleSheet(dlgStyleSheet);
+        symbols.ConfirmationDialog__addWidget(dlg, w);
+        f.obj = group;
+    } else if (f.type == "progress") {
+        NDBProgressBar *p = createProgressBar();
+        p->setMinimum(field.contains("min") ? field.value("min").toInt() : 0);
+        p->setMaximum(field.contains("max") ? field.value("max").toInt() : 100);
+        p->setValue(field.value("value").toInt());
+        if (field.contains("format")) {
+            p->setFormat(field.value("format").toString());
+        }
+        symbols.ConfirmationDialog__addWidget(dlg, p);
+        // The first progress field is the one driven by setProgress()
+        if (!prog) {
+            prog = p;
+        }
+        f.obj = p;
+    } else {
+        DLG_ASSERT(ParamError, false, QString("unknown form field type '%1'").arg(f.type));
+    }
+    formFields.append(f);
+    return Ok;
+}
+
 enum Result NDBCfmDlg::showDialog() {
     DLG_ASSERT(ForbiddenError, dlg, "dialog not open");
     connectStdSignals();
@@ -224,7 +471,7 @@ enum Result NDBCfmDlg::showClose(bool show) {
 
 enum Result NDBCfmDlg::setProgress(int min, int max, int val, QString const& format) {
     DLG_ASSERT(ForbiddenError, dlg, "dialog not open");
-    DLG_ASSERT(ForbiddenError, currActiveType == TypeStd, "not standard dialog");
+    DLG_ASSERT(ForbiddenError, currActiveType != TypeLineEdit, "not standard or form dialog");
     DLG_ASSERT(SymbolError, symbols.ConfirmationDialog__addWidget, "could not find addWidget symbol");
     bool added = true;
     if (min < 0 || max < 0 || val < 0) {
@@ -236,8 +483,7 @@ enum Result NDBCfmDlg::setProgress(int min, int max, int val, QString const& for
         prog->show();
     }
     if (!prog) {
-        prog = new NDBProgressBar();
-        prog->setStyleSheet(dlgStyleSheet);
+        prog = createProgressBar();
         added = false;
     }
     prog->setMinimum(min);
@@ -278,6 +524,129 @@ enum Result NDBCfmDlg::setLEPlaceholder(QString const& placeholder) {
     return Ok;
 }
 
+enum Result NDBCfmDlg::openProgressPipe(bool closeOnEof, int *writeFd) {
+    DLG_ASSERT(ForbiddenError, dlg, "dialog not open");
+    DLG_ASSERT(ForbiddenError, currActiveType != TypeLineEdit, "not standard or form dialog");
+    DLG_ASSERT(ForbiddenError, !progNotifier, "progress pipe already open");
+    DLG_ASSERT(ParamError, writeFd, "writeFd is null");
+    int fds[2];
+    DLG_ASSERT(InitError, pipe2(fds, O_CLOEXEC) == 0, "could not create pipe");
+    // Never let a slow or stalled writer block Nickel's event loop
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    progNotifier = new QSocketNotifier(fds[0], QSocketNotifier::Read, this);
+    QObject::connect(progNotifier, &QSocketNotifier::activated, this, &NDBCfmDlg::onProgressPipeReadable);
+    QObject::connect(dlg, &QObject::destroyed, this, &NDBCfmDlg::closeProgressPipe, Qt::UniqueConnection);
+    progCloseOnEof = closeOnEof;
+    progBuf.clear();
+    *writeFd = fds[1];
+    return Ok;
+}
+
+// Bytes read from the progress pipe per notifier activation. A client that
+// writes faster than this only gets its latest record shown, and the event
+// loop keeps running in between. The notifier fires again while data remains.
+#define NDB_PROG_READ_MAX 4096
+// Longest progress record kept
+#define NDB_PROG_RECORD_MAX 1024
+
+void NDBCfmDlg::onProgressPipeReadable() {
+    if (!progNotifier) {
+        return;
+    }
+    char buf[1024];
+    bool eof = false;
+    QByteArray latest;
+    bool haveLatest = false;
+    for (int total = 0; total < NDB_PROG_READ_MAX;) {
+        ssize_t n = read(progNotifier->socket(), buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            eof = (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+            break;
+        }
+        total += n;
+        progBuf.append(buf, n);
+        // Only the most recent complete record is applied. Anything older
+        // would just cost an extra screen refresh.
+        int end = progBuf.lastIndexOf('\n');
+        if (end >= 0) {
+            int start = (end > 0) ? progBuf.lastIndexOf('\n', end - 1) + 1 : 0;
+            latest = progBuf.mid(start, end - start);
+            haveLatest = true;
+            progBuf.remove(0, end + 1);
+        }
+        if (progBuf.size() > NDB_PROG_RECORD_MAX) {
+            NDB_DEBUG("discarding overlong progress record");
+            progBuf.clear();
+        }
+    }
+    if (haveLatest) {
+        applyProgressRecord(latest);
+    }
+    if (eof) {
+        if (!progBuf.isEmpty()) {
+            applyProgressRecord(progBuf);
+        }
+        closeProgressPipe();
+        if (progCloseOnEof && dlg) {
+            connectStdSignals();
+            closeDialog();
+        }
+    }
+}
+
+void NDBCfmDlg::applyProgressRecord(QByteArray const& record) {
+    QByteArray rec = record.trimmed();
+    if (rec.isEmpty() || !dlg) {
+        return;
+    }
+    int sep = rec.indexOf(' ');
+    bool ok;
+    int val = rec.left(sep).toInt(&ok);
+    if (!ok) {
+        NDB_DEBUG("invalid progress record '%s'", rec.constData());
+        return;
+    }
+    QString format = (sep >= 0) ? QString::fromUtf8(rec.mid(sep + 1)) : QString();
+    if (setProgress(prog ? prog->minimum() : 0, prog ? prog->maximum() : 100, val, format) != Ok) {
+        nh_log("unable to apply progress record: %s", errString.toUtf8().constData());
+    }
+}
+
+void NDBCfmDlg::closeProgressPipe() {
+    if (progNotifier) {
+        int fd = progNotifier->socket();
+        progNotifier->setEnabled(false);
+        progNotifier->deleteLater();
+        progNotifier = nullptr;
+        close(fd);
+    }
+    progBuf.clear();
+}
+
+QVariantMap NDBCfmDlg::getFormValues() {
+    QVariantMap values;
+    DLG_ASSERT(values, currActiveType == TypeForm, "not form dialog");
+    for (int i = 0; i < formFields.size(); ++i) {
+        FormField const& f = formFields.at(i);
+        if (!f.obj) {
+            continue;
+        }
+        if (f.type == "lineedit") {
+            values.insert(f.name, qobject_cast<TouchLineEdit*>(f.obj)->text());
+        } else if (f.type == "checkbox") {
+            values.insert(f.name, qobject_cast<QCheckBox*>(f.obj)->isChecked());
+        } else if (f.type == "choice") {
+            int id = qobject_cast<QButtonGroup*>(f.obj)->checkedId();
+            values.insert(f.name, (id >= 0) ? f.options.at(id) : QString());
+        } else if (f.type == "progress" && !f.name.isEmpty()) {
+            values.insert(f.name, qobject_cast<NDBProgressBar*>(f.obj)->value());
+        }
+    }
+    return values;
+}
+
 QString NDBCfmDlg::getLEText() {
     QString res;
     DLG_ASSERT(res, dlg, "dialog not open");
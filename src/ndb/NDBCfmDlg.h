@@ -7,6 +7,10 @@
 #include <QPointer>
 #include <QProgressBar>
 #include <QCheckBox>
+#include <QButtonGroup>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QVariantMap>
 #include "NDBWidgets.h"
 #include "ndb.h"
 
@@ -21,13 +25,15 @@ namespace NDB {
 class NDBCfmDlg : public QObject {
     Q_OBJECT
     public:
-        enum dialogType {TypeStd, TypeLineEdit};
+        enum dialogType {TypeStd, TypeLineEdit, TypeForm};
         enum Result initResult;
         NDBCfmDlg(QObject* parent);
         ~NDBCfmDlg();
         QString errString;
         QPointer<ConfirmationDialog> dlg;
+        enum dialogType activeType() const { return currActiveType; }
         enum Result createDialog(enum dialogType dlgType);
+        enum Result createForm(QVariantMap const& form);
         enum Result setTitle(const QString& title);
         enum Result setBody(QString const& body);
         enum Result setAccept(QString const& acceptText);
@@ -38,11 +44,21 @@ class NDBCfmDlg : public QObject {
         enum Result setLEPassword(bool isPassword);
         enum Result setLEPlaceholder(QString const& placeholder);
         QString getLEText();
+        QVariantMap getFormValues();
+        enum Result openProgressPipe(bool closeOnEof, int *writeFd);
         enum Result showDialog();
         enum Result closeDialog();
+        // Mangled name to whether it resolved, for ndbCapabilities()
+        static QMap<QString, bool> nickelSymbols;
+        static void startWarming();
+
+    private Q_SLOTS:
+        void onProgressPipeReadable();
+        void closeProgressPipe();
 
     private:
-        struct {
+        // Resolved once, and shared by every dialog
+        static struct Symbols {
             ConfirmationDialog *(*ConfirmationDialogFactory_getConfirmationDialog)(QWidget*);
             ConfirmationDialog *(*ConfirmationDialogFactory_showTextEditDialog)(QString const& title);
             void (*ConfirmationDialog__setTitle)(ConfirmationDialog* _this, QString const&);
@@ -62,13 +78,43 @@ class NDBCfmDlg : public QObject {
             );
             TouchLineEdit *(*N3ConfirmationTextEditField__textEdit)(N3ConfirmationTextEditField* _this);
         } symbols;
+        static bool symbolsResolved;
+        static void resolveSymbols();
+        // Hidden dialogs built ahead of time, so showing one doesn't have to wait
+        static struct WarmDialogs {
+            QPointer<ConfirmationDialog> std;
+            QPointer<ConfirmationDialog> lineEdit;
+            QPointer<N3ConfirmationTextEditField> tef;
+            QPointer<TouchLineEdit> tle;
+            QPointer<NDBProgressBar> prog;
+        } warm;
+        static QTimer *warmTimer;
+        static bool warmEnabled;
+        static int liveDialogs;
+        static void trackDialog(ConfirmationDialog *d);
+        static void dialogGone();
+        static void scheduleWarmDialogs();
+        static void warmDialogs();
+        static const QString dlgStyleSheet;
         enum dialogType currActiveType;
-        QString dlgStyleSheet;
         QPointer<NDBProgressBar> prog;
         QPointer<TouchLineEdit> tle;
         QPointer<N3ConfirmationTextEditField> tef;
-        N3ConfirmationTextEditField* createTextEditField();
+        struct FormField {
+            QString type;
+            QString name;
+            QStringList options;
+            QPointer<QObject> obj;
+        };
+        QList<FormField> formFields;
+        QSocketNotifier *progNotifier = nullptr;
+        QByteArray progBuf;
+        bool progCloseOnEof;
+        static N3ConfirmationTextEditField* createTextEditField(ConfirmationDialog *d);
+        static NDBProgressBar* createProgressBar();
+        enum Result addFormField(QVariantMap const& field, bool isLastLineEdit);
         void connectStdSignals();
+        void applyProgressRecord(QByteArray const& record);
 
 };
 
@@ -1,9 +1,18 @@
 #include <dlfcn.h>
 #include <QApplication>
+#include <QAbstractEventDispatcher>
 #include <QString>
 #include <QWidget>
 #include <QRegExp>
 #include <QStringList>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <atomic>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <string.h>
 #include <NickelHook.h>
@@ -31,6 +40,49 @@ namespace NDB {
  * 
  */
 
+// Number of signals kept for ndbEventsSince()
+#define NDB_JOURNAL_SIZE 256
+// Number of ndbWaitFor() calls that may be waiting at once
+#define NDB_WAIT_MAX 32
+// Property changes within this many ms are sent in one PropertiesChanged signal
+#define NDB_PROP_COALESCE_TIME 50
+
+// Boolean settings that ndbReadSetting() can read
+static const struct {
+    const char *name;
+    const char *vtable;
+    const char *getter; // Read with Settings::getSetting() using key if null
+    const char *key;
+} ndbSettingDescs[] = {
+    {"invert",          "_ZTV15FeatureSettings",   "_ZN15FeatureSettings12invertScreenEv",    nullptr},
+    {"screenshots",     "_ZTV15FeatureSettings",   "_ZN15FeatureSettings11screenshotsEv",     nullptr},
+    {"lockscreen",      "_ZTV13PowerSettings",     "_ZN13PowerSettings16getUnlockEnabledEv",  nullptr},
+    {"dark_mode",       "_ZTV15ReadingSettings",   nullptr,                                   "DarkMode"},
+    {"force_wifi",      "_ZTV17DeveloperSettings", nullptr,                                   "ForceWifiOn"},
+    {"auto_usb_gadget", "_ZTV17DeveloperSettings", nullptr,                                   "AutoUsbGadget"},
+};
+
+/*
+ * The adaptor that D-Bus method calls arrive through, extended to time every
+ * call for the flight recorder. QtDBus invokes adaptor slots through 
+ * qt_metacall(), and sets the call context on the adapted object.
+ */
+class NDBFlightAdapter : public NDBAdapter {
+    public:
+        NDBFlightAdapter(NDBDbus *parent) : NDBAdapter(parent) {}
+        int qt_metacall(QMetaObject::Call c, int id, void **a) override {
+            if (c != QMetaObject::InvokeMetaMethod || id < staticMetaObject.methodOffset() || 
+                staticMetaObject.method(id).methodType() != QMetaMethod::Slot) {
+                return NDBAdapter::qt_metacall(c, id, a);
+            }
+            NDBDbus *ndb = static_cast<NDBDbus*>(parent());
+            ndb->flight.callStarted();
+            int ret = NDBAdapter::qt_metacall(c, id, a);
+            ndb->flightRecordCall(staticMetaObject.method(id).name().constData());
+            return ret;
+        }
+};
+
 /*!
  * \internal
  * \brief Construct a new Nickel D-Bus object
@@ -38,7 +90,13 @@ namespace NDB {
  * \a parent QObject
  */
 NDBDbus::NDBDbus(QObject* parent) : QObject(parent), QDBusContext() {
-    new NDBAdapter(this);
+    if (flight.open(NDB_FLIGHT_PATH, NDB_FLIGHT_SIZE)) {
+        flight.record(NDBFlightRecorder::Start, NH_VERSION);
+    }
+    if (QAbstractEventDispatcher *ed = QAbstractEventDispatcher::instance()) {
+        QObject::connect(ed, &QAbstractEventDispatcher::awake, this, [this]() { flight.awake(); });
+    }
+    new NDBFlightAdapter(this);
     initSucceeded = true;
     nh_log("NickelDBus: registering object %s", NDB_DBUS_OBJECT_PATH);
     if (!conn.registerObject(NDB_DBUS_OBJECT_PATH, this)) {
@@ -60,11 +118,8 @@ NDBDbus::NDBDbus(QObject* parent) : QObject(parent), QDBusContext() {
     }
     // The following symbols are required. If they can't be resolved, bail out
     NDB_RESOLVE_SYMBOL("_ZN11PlugManager14sharedInstanceEv", nh_symoutptr(nSym.PlugManager__sharedInstance));
-    NDB_RESOLVE_SYMBOL("_ZNK11PlugManager10gadgetModeEv", nh_symoutptr(nSym.PlugManager__gadgetMode));
-    if (!nSym.PlugManager__gadgetMode) {
-        // Older firmware versions use a slightly different mangled symbol
-        NDB_RESOLVE_SYMBOL("_ZN11PlugManager10gadgetModeEv", nh_symoutptr(nSym.PlugManager__gadgetMode));
-    }
+    // Older firmware versions use a slightly different mangled symbol
+    NDB_RESOLVE_SYMBOL_OR("_ZNK11PlugManager10gadgetModeEv", "_ZN11PlugManager10gadgetModeEv", nh_symoutptr(nSym.PlugManager__gadgetMode));
     if (!nSym.PlugManager__sharedInstance || !nSym.PlugManager__gadgetMode) {
         initSucceeded = false;
         return;
@@ -92,6 +147,57 @@ NDBDbus::NDBDbus(QObject* parent) : QObject(parent), QDBusContext() {
     // }
     viewTimer->setSingleShot(true);
     QObject::connect(viewTimer, &QTimer::timeout, this, &NDBDbus::handleQSWTimer);
+    // The main window doesn't exist yet when NickelDBus starts
+    viewTrackTimer = new QTimer(this);
+    viewTrackTimer->setInterval(1000);
+    QObject::connect(viewTrackTimer, &QTimer::timeout, this, &NDBDbus::viewTrackStart);
+    viewTrackTimer->start();
+    toastTimer = new QTimer(this);
+    toastTimer->setSingleShot(true);
+    QObject::connect(toastTimer, &QTimer::timeout, this, &NDBDbus::toastShowNext);
+    wmTrackState();
+    waitClock.start();
+    waitTimer = new QTimer(this);
+    waitTimer->setSingleShot(true);
+    QObject::connect(waitTimer, &QTimer::timeout, this, &NDBDbus::waitExpire);
+    waitWatcher = new QDBusServiceWatcher(this);
+    waitWatcher->setConnection(conn);
+    waitWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    QObject::connect(waitWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &NDBDbus::onWaiterGone);
+    // Before the journal, so that the page is updated after every signal
+    stateOpen();
+    journalTrackSignals();
+    usbmsPollTimer = new QTimer(this);
+    usbmsPollTimer->setInterval(1000);
+    QObject::connect(usbmsPollTimer, &QTimer::timeout, this, &NDBDbus::usbmsPoll);
+    QObject::connect(this, &NDBDbus::pfmAboutToConnect, this, [this]() { usbmsUpdate(true); });
+    QObject::connect(this, &NDBDbus::pfmDoneProcessing, this, [this]() { usbmsUpdate(ndbGadgetMode()); });
+    usbmsDeferClock.start();
+    usbmsDeferTimer = new QTimer(this);
+    usbmsDeferTimer->setSingleShot(true);
+    QObject::connect(usbmsDeferTimer, &QTimer::timeout, this, &NDBDbus::usbmsExpireDeferred);
+    usbmsDeferWatcher = new QDBusServiceWatcher(this);
+    usbmsDeferWatcher->setConnection(conn);
+    usbmsDeferWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    QObject::connect(usbmsDeferWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &NDBDbus::onUsbmsDeferClientGone);
+    wifiLeaseClock.start();
+    wifiLeaseTimer = new QTimer(this);
+    wifiLeaseTimer->setSingleShot(true);
+    QObject::connect(wifiLeaseTimer, &QTimer::timeout, this, &NDBDbus::wifiKeepaliveUpdate);
+    wifiLeaseWatcher = new QDBusServiceWatcher(this);
+    wifiLeaseWatcher->setConnection(conn);
+    wifiLeaseWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    QObject::connect(wifiLeaseWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &NDBDbus::onWifiLeaseOwnerGone);
+    dlgOwnerWatcher = new QDBusServiceWatcher(this);
+    dlgOwnerWatcher->setConnection(conn);
+    dlgOwnerWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    QObject::connect(dlgOwnerWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &NDBDbus::onDlgOwnerGone);
+    propTimer = new QTimer(this);
+    propTimer->setSingleShot(true);
+    propTimer->setInterval(NDB_PROP_COALESCE_TIME);
+    QObject::connect(propTimer, &QTimer::timeout, this, &NDBDbus::propEmitChanged);
+    QObject::connect(this, &NDBDbus::ndbViewChanged, this, [this]() { propChanged("currentView"); });
+    QObject::connect(this, &NDBDbus::ndbUsbmsStateChanged, this, [this]() { propChanged("usbmsActive"); });
 
     // Resolve the rest of the Nickel symbols up-front
     // PlugWorkFlowManager
@@ -110,14 +216,26 @@ NDBDbus::NDBDbus(QObject* parent) : QObject(parent), QDBusContext() {
     NDB_RESOLVE_SYMBOL("_ZN6Device16getCurrentDeviceEv", nh_symoutptr(nSym.Device__getCurrentDevice));
     NDB_RESOLVE_SYMBOL("_ZNK6Device9userAgentEv", nh_symoutptr(nSym.Device__userAgent));
     // MWC views
-    NDB_RESOLVE_SYMBOL("_ZNK20MainWindowController11currentViewEv", nh_symoutptr(nSym.MainWindowController_currentView));
-    if (!nSym.MainWindowController_currentView) {
-        // Older firmware versions use a slightly different mangled symbol name
-        NDB_RESOLVE_SYMBOL("_ZN20MainWindowController11currentViewEv", nh_symoutptr(nSym.MainWindowController_currentView));
-    }
+    // Older firmware versions use a slightly different mangled symbol name
+    NDB_RESOLVE_SYMBOL_OR("_ZNK20MainWindowController11currentViewEv", "_ZN20MainWindowController11currentViewEv", nh_symoutptr(nSym.MainWindowController_currentView));
     // Image
     NDB_RESOLVE_SYMBOL("_ZN5Image11sizeForTypeERK6DeviceRK7QString", nh_symoutptr(nSym.Image__sizeForType));
     NDB_RESOLVE_SYMBOL("_ZN16WirelessWatchdog14sharedInstanceEv", nh_symoutptr(nSym.WirelessWatchdog__sharedInstance));
+    // Settings (for reading the current value of a setting)
+    // Older firmware versions don't have the bool parameter
+    nickelSymbols.insert(QStringLiteral("_ZN8SettingsC2ERK6Deviceb"), 
+        resolveSymbol(libnickel, "_ZN8SettingsC2ERK6Deviceb", nh_symoutptr(nSym.Settings__Settings)) || 
+        resolveSymbol(libnickel, "_ZN8SettingsC2ERK6Device", nh_symoutptr(nSym.Settings__SettingsLegacy)));
+    NDB_RESOLVE_SYMBOL("_ZN8SettingsD2Ev", nh_symoutptr(nSym.Settings__SettingsD));
+    NDB_RESOLVE_SYMBOL("_ZN8Settings10getSettingERK7QStringRK8QVariant", nh_symoutptr(nSym.Settings__getSetting));
+    // ndbReadSetting() looks these up when it is called
+    nickelSymbols.insert(QStringLiteral("_ZTV8Settings"), dlsym(libnickel, "_ZTV8Settings") != nullptr);
+    for (auto const& d : ndbSettingDescs) {
+        nickelSymbols.insert(QString::fromLatin1(d.vtable), dlsym(libnickel, d.vtable) != nullptr);
+        if (d.getter) {
+            nickelSymbols.insert(QString::fromLatin1(d.getter), dlsym(libnickel, d.getter) != nullptr);
+        }
+    }
 }
 
 /*!
@@ -155,6 +273,9 @@ void NDBDbus::connectSignals() {
         if (wf) {
             ndbConnectSignal<PlugWorkflowManager>(wf, SIGNAL(aboutToConnect()), SIGNAL(pfmAboutToConnect()));
             ndbConnectSignal<PlugWorkflowManager>(wf, SIGNAL(doneProcessing()), SIGNAL(pfmDoneProcessing()));
+            // Without both signals, the USBMS state has to be queried on every call
+            usbmsTracked = connectedSignals.contains("pfmAboutToConnect") && connectedSignals.contains("pfmDoneProcessing");
+            usbmsActive = ndbGadgetMode();
         } else {
             nh_log("could not get shared PlugWorkflowManager pointer");
         }
@@ -177,6 +298,8 @@ void NDBDbus::connectSignals() {
             nh_log("could not get shared WirelessManager pointer");
         }
     }
+    propChanged("connectedSignals");
+    stateUpdate();
 }
 
 /*!
@@ -213,12 +336,29 @@ void NDBDbus::handleQSWCurrentChanged(int index) {
     }
 }
 
+/*!
+ * \internal
+ * \brief Start tracking view changes, once Nickel's main window exists
+ */
+void NDBDbus::viewTrackStart() {
+    QString view = viewCurrent();
+    if (!stackedWidget) {
+        return;
+    }
+    viewTrackTimer->stop();
+    stateView = view;
+    stateUpdate();
+    NDBCfmDlg::startWarming();
+}
+
 /*!
  * \internal
  * \brief Emits ndbViewChanged() after a small timeout
  */
 void NDBDbus::handleQSWTimer() {
-    emit ndbViewChanged(ndbCurrentView());
+    QString view = viewCurrent();
+    flight.record(NDBFlightRecorder::View, view.toUtf8());
+    emit ndbViewChanged(view);
 }
 
 /*!
@@ -235,6 +375,27 @@ QString NDBDbus::ndbCurrentView() {
     NDB_DBUS_ASSERT(name, QDBusError::InternalError, mwc, "unable to get shared MainWindowController instance");
     QWidget *cv = nSym.MainWindowController_currentView(mwc);
     NDB_DBUS_ASSERT(name, QDBusError::InternalError, cv, "unable to get current view from MainWindowController");
+    name = viewCurrent();
+    NDB_DBUS_SYM_ASSERT(name, name != "N3Dialog" || nSym.N3Dialog__content);
+    return name;
+}
+
+/*!
+ * \internal
+ * \brief Get the class name of the current view, and track view changes from now on
+ * 
+ * Unlike \l ndbCurrentView(), this never replies with an error. Returns an 
+ * empty string if the current view can't be found.
+ */
+QString NDBDbus::viewCurrent() {
+    if (!nSym.MainWindowController_sharedInstance || !nSym.MainWindowController_currentView) {
+        return QString();
+    }
+    MainWindowController *mwc = nSym.MainWindowController_sharedInstance();
+    QWidget *cv = mwc ? nSym.MainWindowController_currentView(mwc) : nullptr;
+    if (!cv) {
+        return QString();
+    }
     if (!stackedWidget) {
         if (QString(cv->parentWidget()->metaObject()->className()) == "QStackedWidget") {
             stackedWidget = static_cast<QStackedWidget*>(cv->parentWidget());
@@ -244,10 +405,9 @@ QString NDBDbus::ndbCurrentView() {
             nh_log("expected QStackedWidget, got %s", cv->parentWidget()->metaObject()->className());
         }
     }
-    name = cv->objectName();
+    QString name = cv->objectName();
     if (name == "N3Dialog") {
-        NDB_DBUS_SYM_ASSERT(name, nSym.N3Dialog__content);
-        if (QWidget *c = nSym.N3Dialog__content(cv)) {
+        if (QWidget *c = nSym.N3Dialog__content ? nSym.N3Dialog__content(cv) : nullptr) {
             name = c->objectName();
         }
     } else if (name == "ReadingView") {
@@ -257,9 +417,684 @@ QString NDBDbus::ndbCurrentView() {
 }
 
 bool NDBDbus::ndbInUSBMS() {
+    return usbmsTracked ? usbmsActive : ndbGadgetMode();
+}
+
+bool NDBDbus::ndbGadgetMode() {
     return nSym.PlugManager__gadgetMode(nSym.PlugManager__sharedInstance());
 }
 
+#define NDB_USBMS_CONNECT_GRACE 30000
+
+/*!
+ * \internal
+ * \brief Record a change of USB mass storage state to \a active
+ */
+void NDBDbus::usbmsUpdate(bool active) {
+    if (active == usbmsActive) {
+        return;
+    }
+    nh_log("usbms session %s", active ? "started" : "ended");
+    flight.record(NDBFlightRecorder::Usbms, QByteArray(), QByteArray(), 0, active);
+    usbmsActive = active;
+    if (active) {
+        // Gadget mode is enabled a while after aboutToConnect. Watch it so
+        // that a session which ends without doneProcessing is noticed.
+        usbmsSawGadget = false;
+        usbmsSince.start();
+        usbmsPollTimer->start();
+    } else {
+        usbmsPollTimer->stop();
+        if (!usbmsDeferred.isEmpty()) {
+            QTimer::singleShot(0, this, SLOT(usbmsReplayDeferred()));
+        }
+    }
+    emit ndbUsbmsStateChanged(active);
+}
+
+/*!
+ * \internal
+ * \brief Check whether a USB mass storage session is still going on
+ */
+void NDBDbus::usbmsPoll() {
+    if (!usbmsTracked) {
+        // Only polled while calls are deferred
+        if (!ndbGadgetMode()) {
+            usbmsPollTimer->stop();
+            usbmsReplayDeferred();
+        } else if (usbmsDeferred.isEmpty()) {
+            usbmsPollTimer->stop();
+        }
+        return;
+    }
+    if (ndbGadgetMode()) {
+        usbmsSawGadget = true;
+    } else if (usbmsSawGadget || usbmsSince.elapsed() > NDB_USBMS_CONNECT_GRACE) {
+        usbmsUpdate(false);
+    }
+}
+
+/*!
+ * \brief Check whether a USB mass storage session is active
+ * 
+ * Returns \c true while the device is connected to a computer in USB mass 
+ * storage mode. Most methods fail during a session. This value is cached, so it
+ * is cheap to call. \l ndbUsbmsStateChanged() is emitted when it changes.
+ * 
+ * \since 0.4.0
+ */
+bool NDBDbus::ndbUsbmsActive() {
+    return ndbInUSBMS();
+}
+
+#define NDB_USBMS_DEFER_MAX 32
+#define NDB_USBMS_DEFER_EXPIRY 600000
+// Name of the connection deferred calls are replayed over
+#define NDB_USBMS_REPLAY_CONN "ndb-usbms-replay"
+
+/*!
+ * \brief Queue calls made during a USB mass storage session instead of failing them
+ * 
+ * If \a defer is \c true, methods called by this client while a USB mass storage
+ * session is active are no longer rejected with an error. They are queued, and
+ * run in order once the session ends, at which point each gets its reply. A queued
+ * call that has not run within \a expiry milliseconds (or ten minutes, if 
+ * \a expiry is \c 0) fails with a timeout error. At most 32 calls are queued at
+ * once, across all clients. Further calls fail as usual.
+ * 
+ * The setting applies until it is turned off with \a defer set to \c false, or
+ * the client disconnects from D-Bus. Calls already queued are kept when it is 
+ * turned off.
+ * 
+ * Methods whose result belongs to the caller, such as \l ndbWifiKeepaliveAcquire(),
+ * \l dlgCreate() and the \c dlgPrompt* methods, are never queued, since queued
+ * calls are made again by NickelDBus itself once the session ends.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::ndbUsbmsDefer(bool defer, int expiry) {
+    NDB_DBUS_ASSERT((void) 0, QDBusError::NotSupported, calledFromDBus(), "only D-Bus clients can defer calls");
+    NDB_DBUS_ASSERT((void) 0, QDBusError::NotSupported, !message().service().isEmpty(), "deferring calls is not supported on peer connections");
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, expiry >= 0, "expiry must not be negative");
+    QString client = message().service();
+    if (defer) {
+        usbmsDeferClients.insert(client, expiry > 0 ? expiry : NDB_USBMS_DEFER_EXPIRY);
+    } else {
+        usbmsDeferClients.remove(client);
+    }
+    usbmsDeferWatcher->setWatchedServices(usbmsDeferClients.keys());
+}
+
+/*!
+ * \brief Describe what this NickelDBus instance supports, in a single call
+ * 
+ * The returned map has the following keys:
+ * 
+ * \list
+ *   \li \c version - the NickelDBus version, as returned by \l ndbVersion()
+ *   \li \c interfaceHash - a SHA-1 hash of the D-Bus interface description. 
+ *       It only changes when methods, signals or properties do, so clients
+ *       can cache everything else in this map (apart from \c connectedSignals) 
+ *       keyed on it, and skip introspection.
+ *   \li \c methods - the names of the methods
+ *   \li \c signals - the names of the signals
+ *   \li \c properties - the names of the properties
+ *   \li \c symbols - the Nickel symbols that were resolved on this firmware
+ *   \li \c missingSymbols - the Nickel symbols that could not be resolved.
+ *       Methods that need them fail. A symbol that older firmware names 
+ *       differently is listed once, under its current name, in \c symbols 
+ *       if either name was resolved.
+ *   \li \c connectedSignals - the signals that will actually be emitted, as 
+ *       with \l ndbSignalConnected()
+ * \endlist
+ * 
+ * \since 0.4.0
+ */
+QVariantMap NDBDbus::ndbCapabilities() {
+    QVariantMap caps;
+    QMetaObject const& mo = NDBAdapter::staticMetaObject;
+    QByteArray iface = mo.classInfo(mo.indexOfClassInfo("D-Bus Introspection")).value();
+    QStringList methods, signalNames, props, symbols, missing;
+    for (int i = mo.methodOffset(); i < mo.methodCount(); ++i) {
+        QMetaMethod m = mo.method(i);
+        QStringList& names = (m.methodType() == QMetaMethod::Signal) ? signalNames : methods;
+        QString name = QString::fromLatin1(m.name());
+        // Methods with default arguments appear once per overload
+        if (!names.contains(name)) {
+            names.append(name);
+        }
+    }
+    for (int i = mo.propertyOffset(); i < mo.propertyCount(); ++i) {
+        props.append(QString::fromLatin1(mo.property(i).name()));
+    }
+    QMap<QString, bool> allSymbols = nickelSymbols;
+    for (auto it = NDBCfmDlg::nickelSymbols.constBegin(); it != NDBCfmDlg::nickelSymbols.constEnd(); ++it) {
+        allSymbols.insert(it.key(), it.value());
+    }
+    for (auto it = allSymbols.constBegin(); it != allSymbols.constEnd(); ++it) {
+        (it.value() ? symbols : missing).append(it.key());
+    }
+    caps.insert("version", ndbVersion());
+    caps.insert("interfaceHash", QString::fromLatin1(QCryptographicHash::hash(iface, QCryptographicHash::Sha1).toHex()));
+    caps.insert("methods", methods);
+    caps.insert("signals", signalNames);
+    caps.insert("properties", props);
+    caps.insert("symbols", symbols);
+    caps.insert("missingSymbols", missing);
+    caps.insert("connectedSignals", propConnectedSignals());
+    return caps;
+}
+
+/*!
+ * \brief Get the signals emitted after the one numbered \a seq
+ * 
+ * NickelDBus numbers every signal it emits, starting at \c 1, and keeps the 
+ * last 256 of them. Returns at most \a max of those with a sequence number 
+ * greater than \a seq, oldest first. \a latest is set to the sequence number 
+ * of the newest signal, to be passed as \a seq next time.
+ * 
+ * Each event is a map with the following keys:
+ * 
+ * \list
+ *   \li \c seq - the sequence number of the signal
+ *   \li \c time - when the signal was emitted, in milliseconds since the epoch
+ *   \li \c name - the name of the signal, such as \c ndbViewChanged
+ *   \li \c args - the arguments of the signal
+ * \endlist
+ * 
+ * To never miss a signal, call this with \a max set to \c 0 before subscribing, 
+ * which only sets \a latest. Signals emitted before the subscription became 
+ * active can then be fetched with \a latest as \a seq. If the first returned 
+ * event is numbered higher than \a seq + 1, events were dropped from the 
+ * journal before they could be fetched.
+ * 
+ * \since 0.4.0
+ */
+QVariantList NDBDbus::ndbEventsSince(qulonglong seq, int max, qulonglong& latest) {
+    QVariantList events;
+    latest = journalSeq;
+    qulonglong oldest = (journalSeq > NDB_JOURNAL_SIZE) ? journalSeq - NDB_JOURNAL_SIZE + 1 : 1;
+    for (qulonglong s = qMax(seq + 1, oldest); s <= journalSeq && events.size() < max; ++s) {
+        JournalEvent const& e = journal.at((s - 1) % NDB_JOURNAL_SIZE);
+        QVariantMap ev;
+        ev.insert("seq", e.seq);
+        ev.insert("time", e.time);
+        ev.insert("name", e.name);
+        ev.insert("args", e.args);
+        events.append(ev);
+    }
+    return events;
+}
+
+/*!
+ * \internal
+ * \brief Record \a name and \a args of an emitted signal in the journal
+ */
+void NDBDbus::journalAppend(const char *name, QVariantList const& args) {
+    JournalEvent& e = journal[journalSeq % NDB_JOURNAL_SIZE];
+    e.seq = ++journalSeq;
+    e.time = QDateTime::currentMSecsSinceEpoch();
+    e.name = QString(name);
+    e.args = args;
+    QStringList text;
+    for (QVariant const& a : args) {
+        text.append(a.toString());
+    }
+    flight.record(NDBFlightRecorder::Signal, name, text.join(' ').toUtf8());
+    stateUpdate();
+    if (!waiters.isEmpty()) {
+        waitNotify(e.name, args);
+    }
+}
+
+/*!
+ * \brief Wait until the signal \a signalName is emitted, or has effectively already happened
+ * 
+ * If \a predicate is empty, any emission of \a signalName matches. Otherwise the 
+ * arguments of the signal, converted to text and separated by spaces, must be 
+ * equal to \a predicate, ignoring case. For example, \c ndbViewChanged with \c ReadingView waits
+ * until a book is opened, and \c dlgResult with \c{3 1} waits until dialog \c 3 
+ * is accepted.
+ * 
+ * For signals that reflect state NickelDBus tracks, this returns immediately if 
+ * the state already matches:
+ * 
+ * \list
+ *   \li \c ndbViewChanged - the current view is \a predicate
+ *   \li \c rvPageChanged - the current page is \a predicate
+ *   \li \c wmNetworkConnected - Wifi is connected
+ *   \li \c wmNetworkDisconnected - Wifi is known to be disconnected
+ *   \li \c wmWifiEnabled - Wifi is known to be enabled (\c true) or disabled (\c false)
+ *   \li \c ndbUsbmsStateChanged - a USB mass storage session is (\c true) or isn't 
+ *       (\c false) active
+ *   \li \c pfmAboutToConnect - a USB mass storage session is active
+ * \endlist
+ * 
+ * Otherwise the reply is sent when a matching signal is emitted, or fails with a
+ * timeout error after \a timeout milliseconds. Set \a timeout to \c 0 to wait
+ * indefinitely. Up to 32 calls can wait at once. A call is dropped if its caller
+ * disconnects from the bus.
+ * 
+ * The reply has the same keys as the events returned by \l ndbEventsSince(). If
+ * the state already matched, \c args is empty, and \c seq is that of the last
+ * signal emitted.
+ * 
+ * \since 0.4.0
+ */
+QVariantMap NDBDbus::ndbWaitFor(QString const& signalName, QString const& predicate, int timeout) {
+    QVariantMap ev;
+    NDB_DBUS_ASSERT(ev, QDBusError::NotSupported, calledFromDBus(), "ndbWaitFor can only be called over D-Bus");
+    NDB_DBUS_ASSERT(ev, QDBusError::InvalidArgs, timeout >= 0, "timeout must not be negative");
+    bool known = false;
+    for (int i = staticMetaObject.methodOffset(); i < staticMetaObject.methodCount() && !known; ++i) {
+        QMetaMethod m = staticMetaObject.method(i);
+        known = (m.methodType() == QMetaMethod::Signal && QString::fromLatin1(m.name()) == signalName);
+    }
+    NDB_DBUS_ASSERT(ev, QDBusError::InvalidArgs, known, "unknown signal: %s", signalName.toUtf8().constData());
+    if (waitStateHolds(signalName, predicate)) {
+        ev.insert("seq", journalSeq);
+        ev.insert("time", QDateTime::currentMSecsSinceEpoch());
+        ev.insert("name", signalName);
+        ev.insert("args", QVariantList());
+        return ev;
+    }
+    NDB_DBUS_ASSERT(ev, QDBusError::LimitsExceeded, waiters.size() < NDB_WAIT_MAX, "too many callers waiting");
+    Waiter w;
+    w.signalName = signalName;
+    w.predicate = predicate;
+    w.deadline = (timeout > 0) ? waitClock.elapsed() + timeout : 0;
+    w.owner = calledFromDBus() ? message().service() : QString();
+    ndbDelayReply(w.reply);
+    waiters.append(w);
+    if (!w.owner.isEmpty()) {
+        waitWatcher->addWatchedService(w.owner);
+    }
+    if (w.deadline && (!waitTimer->isActive() || waitTimer->remainingTime() > timeout)) {
+        waitTimer->start(timeout);
+    }
+    return ev;
+}
+
+/*!
+ * \internal
+ * \brief Check whether the tracked state already matches what ndbWaitFor() waits for
+ */
+bool NDBDbus::waitStateHolds(QString const& signalName, QString const& predicate) {
+    bool want = predicate.compare("true", Qt::CaseInsensitive) == 0;
+    bool boolPred = want || predicate.compare("false", Qt::CaseInsensitive) == 0;
+    // Predicates are compared the same way as in waitNotify()
+    if (signalName == "ndbViewChanged") {
+        return !predicate.isEmpty() && viewCurrent().compare(predicate, Qt::CaseInsensitive) == 0;
+    } else if (signalName == "rvPageChanged") {
+        return !predicate.isEmpty() && QString::number(stateBookPage).compare(predicate, Qt::CaseInsensitive) == 0;
+    } else if (signalName == "wmNetworkConnected") {
+        return wmSt.connected;
+    } else if (signalName == "wmNetworkDisconnected") {
+        return wmSt.enabledKnown && !wmSt.connected;
+    } else if (signalName == "wmWifiEnabled") {
+        return boolPred && wmSt.enabledKnown && wmSt.enabled == want;
+    } else if (signalName == "ndbUsbmsStateChanged") {
+        return boolPred && ndbInUSBMS() == want;
+    } else if (signalName == "pfmAboutToConnect") {
+        return ndbInUSBMS();
+    }
+    return false;
+}
+
+/*!
+ * \internal
+ * \brief Reply to the ndbWaitFor() callers waiting for the signal \a name with \a args
+ */
+void NDBDbus::waitNotify(QString const& name, QVariantList const& args) {
+    QStringList text;
+    for (QVariant const& a : args) {
+        text.append(a.toString());
+    }
+    QString joined = text.join(' ');
+    for (auto it = waiters.begin(); it != waiters.end();) {
+        if (it->signalName == name && (it->predicate.isEmpty() || it->predicate.compare(joined, Qt::CaseInsensitive) == 0)) {
+            QVariantMap ev;
+            ev.insert("seq", journalSeq);
+            ev.insert("time", QDateTime::currentMSecsSinceEpoch());
+            ev.insert("name", name);
+            ev.insert("args", args);
+            ndbSendDelayedReply(it->reply, QList<QVariant>() << ev);
+            QString owner = it->owner;
+            it = waiters.erase(it);
+            waitUnwatch(owner);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Stop watching \a owner once it has no ndbWaitFor() calls left
+ */
+void NDBDbus::waitUnwatch(QString const& owner) {
+    if (owner.isEmpty()) {
+        return;
+    }
+    for (Waiter const& w : waiters) {
+        if (w.owner == owner) {
+            return;
+        }
+    }
+    waitWatcher->removeWatchedService(owner);
+}
+
+/*!
+ * \internal
+ * \brief Drop the ndbWaitFor() calls of bus name \a name, which has disconnected
+ */
+void NDBDbus::onWaiterGone(QString const& name) {
+    for (auto it = waiters.begin(); it != waiters.end();) {
+        if (it->owner == name) {
+            it = waiters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    waitWatcher->removeWatchedService(name);
+}
+
+/*!
+ * \internal
+ * \brief Fail the ndbWaitFor() calls that have timed out
+ */
+void NDBDbus::waitExpire() {
+    qint64 now = waitClock.elapsed();
+    qint64 next = -1;
+    for (auto it = waiters.begin(); it != waiters.end();) {
+        if (it->deadline && it->deadline <= now) {
+            ndbSendDelayedError(it->reply, QDBusError::Timeout, QString("timed out waiting for %1").arg(it->signalName));
+            QString owner = it->owner;
+            it = waiters.erase(it);
+            waitUnwatch(owner);
+        } else {
+            if (it->deadline) {
+                next = (next < 0) ? it->deadline : qMin(next, it->deadline);
+            }
+            ++it;
+        }
+    }
+    if (next >= 0) {
+        waitTimer->start(next - now);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Record a call to \a method, which has just returned, in the flight recorder
+ */
+void NDBDbus::flightRecordCall(const char *method) {
+    QByteArray caller = calledFromDBus() ? message().service().toUtf8() : QByteArray();
+    quint8 flags = (calledFromDBus() && isDelayedReply()) ? NDBFlightRecorder::DelayedReply : 0;
+    flight.record(NDBFlightRecorder::Call, method, caller, 0, flags);
+}
+
+template <typename... Args>
+void NDBDbus::journalSignal(void (NDBDbus::*sig)(Args...), const char *name) {
+    QObject::connect(this, sig, this, [this, name](Args... args) {
+        journalAppend(name, QVariantList{QVariant::fromValue(args)...});
+    });
+}
+
+#define NDB_JOURNAL_SIGNAL(sig) journalSignal(&NDBDbus::sig, #sig)
+
+/*!
+ * \internal
+ * \brief Record every signal NickelDBus emits in the journal
+ */
+void NDBDbus::journalTrackSignals() {
+    journal.resize(NDB_JOURNAL_SIZE);
+    NDB_JOURNAL_SIGNAL(dlgConfirmResult);
+    NDB_JOURNAL_SIGNAL(dlgConfirmTextInput);
+    NDB_JOURNAL_SIGNAL(dlgResult);
+    NDB_JOURNAL_SIGNAL(dlgTextInput);
+    NDB_JOURNAL_SIGNAL(pfmDoneProcessing);
+    NDB_JOURNAL_SIGNAL(pfmAboutToConnect);
+    NDB_JOURNAL_SIGNAL(fssFinished);
+    NDB_JOURNAL_SIGNAL(fssGotNumFilesToProcess);
+    NDB_JOURNAL_SIGNAL(fssParseProgress);
+    NDB_JOURNAL_SIGNAL(wmTryingToConnect);
+    NDB_JOURNAL_SIGNAL(wmNetworkConnected);
+    NDB_JOURNAL_SIGNAL(wmNetworkDisconnected);
+    NDB_JOURNAL_SIGNAL(wmNetworkForgotten);
+    NDB_JOURNAL_SIGNAL(wmNetworkFailedToConnect);
+    NDB_JOURNAL_SIGNAL(wmScanningStarted);
+    NDB_JOURNAL_SIGNAL(wmScanningFinished);
+    NDB_JOURNAL_SIGNAL(wmScanningAborted);
+    NDB_JOURNAL_SIGNAL(wmWifiEnabled);
+    NDB_JOURNAL_SIGNAL(wmLinkQualityForConnectedNetwork);
+    NDB_JOURNAL_SIGNAL(wmMacAddressAvailable);
+    NDB_JOURNAL_SIGNAL(ndbViewChanged);
+    NDB_JOURNAL_SIGNAL(rvPageChanged);
+    NDB_JOURNAL_SIGNAL(ndbUsbmsStateChanged);
+}
+
+/*!
+ * \brief Accept direct connections from clients
+ * 
+ * If \a listen is \c true, NickelDBus also listens on a private Unix socket,
+ * and exports the same methods, signals and properties on every connection 
+ * made to it. Such peer-to-peer connections bypass the D-Bus daemon, which 
+ * makes calls and signals considerably cheaper. This is worthwhile for 
+ * clients that make many calls, such as progress reporters.
+ * 
+ * Returns the address to connect to, for example with 
+ * \c QDBusConnection::connectToPeer() or \c{qndb --peer}. Use an empty service
+ * name when creating a proxy for a peer connection.
+ * 
+ * If \a listen is \c false, NickelDBus stops listening, and closes all peer
+ * connections. Returns an empty string.
+ * 
+ * The system bus name remains available regardless.
+ * 
+ * \note Peer connections have no bus name. Keepalive leases taken over a peer
+ * connection are not released when the client exits, and calls can't be 
+ * deferred with \l ndbUsbmsDefer().
+ * 
+ * \since 0.4.0
+ */
+QString NDBDbus::ndbPeerListen(bool listen) {
+    if (!listen) {
+        if (peerServer) {
+            nh_log("no longer listening for peer connections");
+            delete peerServer;
+            peerServer = nullptr;
+        }
+        for (QDBusConnection const& c : peerConns) {
+            QDBusConnection::disconnectFromPeer(c.name());
+        }
+        peerConns.clear();
+        return QString();
+    }
+    if (!peerServer) {
+        peerServer = new QDBusServer(QStringLiteral(NDB_DBUS_PEER_ADDRESS), this);
+        if (!peerServer->isConnected()) {
+            QString err = peerServer->lastError().message();
+            delete peerServer;
+            peerServer = nullptr;
+            NDB_DBUS_ASSERT(QString(), QDBusError::Failed, false, "could not listen on %s: %s", NDB_DBUS_PEER_ADDRESS, err.toUtf8().constData());
+        }
+        QObject::connect(peerServer, &QDBusServer::newConnection, this, &NDBDbus::onPeerConnection);
+        nh_log("listening for peer connections on %s", NDB_DBUS_PEER_ADDRESS);
+    }
+    return peerServer->address();
+}
+
+/*!
+ * \internal
+ * \brief Export NickelDBus on the new \a peer connection
+ */
+void NDBDbus::onPeerConnection(QDBusConnection const& peer) {
+    QDBusConnection c(peer);
+    if (!c.registerObject(NDB_DBUS_OBJECT_PATH, this)) {
+        nh_log("failed to register object on peer connection %s", c.name().toUtf8().constData());
+        QDBusConnection::disconnectFromPeer(c.name());
+        return;
+    }
+    NDB_DEBUG("new peer connection %s", c.name().toUtf8().constData());
+    for (auto it = peerConns.begin(); it != peerConns.end();) {
+        it = it->isConnected() ? it + 1 : peerConns.erase(it);
+    }
+    peerConns.append(c);
+}
+
+/*!
+ * \internal
+ * \brief Queue the current call until the USBMS session ends, if the caller asked for it
+ * 
+ * Returns \c true if the call was queued, in which case the method must return 
+ * without doing anything.
+ */
+bool NDBDbus::ndbUsbmsDeferCall() {
+    // Property reads aren't method calls that can be replayed
+    // Methods that record their caller would see NickelDBus calling them once replayed
+    static const QSet<QString> callerScoped = {
+        "ndbWifiKeepaliveAcquire", "dlgCreate", "dlgConfirmForm",
+        "dlgPromptConfirm", "dlgPromptText", "dlgPromptPassword",
+    };
+    if (!calledFromDBus() || !usbmsDeferClients.contains(message().service()) || message().interface() == QLatin1String("org.freedesktop.DBus.Properties")) {
+        return false;
+    }
+    if (callerScoped.contains(message().member())) {
+        nh_log("not deferring %s: replies to the caller", message().member().toUtf8().constData());
+        return false;
+    }
+    if (usbmsDeferred.size() >= NDB_USBMS_DEFER_MAX) {
+        nh_log("not deferring %s: queue is full", message().member().toUtf8().constData());
+        return false;
+    }
+    DeferredCall c;
+    ndbDelayReply(c.reply);
+    c.deadline = usbmsDeferClock.elapsed() + usbmsDeferClients.value(message().service());
+    usbmsDeferred.append(c);
+    NDB_DEBUG("deferring %s until the usbms session ends", message().member().toUtf8().constData());
+    if (!usbmsDeferTimer->isActive() || usbmsDeferTimer->remainingTime() > c.deadline - usbmsDeferClock.elapsed()) {
+        usbmsDeferTimer->start(c.deadline - usbmsDeferClock.elapsed());
+    }
+    // Without the PlugWorkflowManager signals, only polling notices the end of the session
+    if (!usbmsTracked && !usbmsPollTimer->isActive()) {
+        usbmsPollTimer->start();
+    }
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Fail queued calls whose deadline has passed
+ */
+void NDBDbus::usbmsExpireDeferred() {
+    qint64 now = usbmsDeferClock.elapsed();
+    qint64 next = -1;
+    for (auto it = usbmsDeferred.begin(); it != usbmsDeferred.end();) {
+        if (it->deadline <= now) {
+            ndbSendDelayedError(it->reply, QDBusError::Timeout, "deferred call expired before the usbms session ended");
+            it = usbmsDeferred.erase(it);
+        } else {
+            next = (next < 0) ? it->deadline : qMin(next, it->deadline);
+            ++it;
+        }
+    }
+    if (next >= 0) {
+        usbmsDeferTimer->start(next - now);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Run the calls queued during the USBMS session that just ended
+ * 
+ * Each call is sent again over a separate connection, so that it is handled
+ * like any other D-Bus call, and its reply is passed on to the original caller.
+ * Calls sent from one connection are handled in order.
+ */
+void NDBDbus::usbmsReplayDeferred() {
+    usbmsExpireDeferred();
+    if (ndbInUSBMS() || usbmsDeferred.isEmpty()) {
+        return;
+    }
+    usbmsDeferTimer->stop();
+    QDBusConnection replayConn = QDBusConnection::connectToBus(QDBusConnection::SystemBus, QStringLiteral(NDB_USBMS_REPLAY_CONN));
+    for (DeferredCall const& c : usbmsDeferred) {
+        QDBusMessage call = QDBusMessage::createMethodCall(NDB_DBUS_IFACE_NAME, NDB_DBUS_OBJECT_PATH, c.reply.msg.interface(), c.reply.msg.member());
+        call.setArguments(c.reply.msg.arguments());
+        NDBDelayedReply reply = c.reply;
+        QDBusPendingCallWatcher *w = new QDBusPendingCallWatcher(replayConn.asyncCall(call, INT_MAX), this);
+        QObject::connect(w, &QDBusPendingCallWatcher::finished, this, [reply](QDBusPendingCallWatcher *w) {
+            QDBusMessage r = w->reply();
+            if (r.type() == QDBusMessage::ErrorMessage) {
+                reply.conn.send(reply.msg.createErrorReply(r.errorName(), r.errorMessage()));
+            } else {
+                reply.conn.send(reply.msg.createReply(r.arguments()));
+            }
+            w->deleteLater();
+        });
+    }
+    usbmsDeferred.clear();
+}
+
+/*!
+ * \internal
+ * \brief Forget the client \a name, which has disconnected, and drop its queued calls
+ */
+void NDBDbus::onUsbmsDeferClientGone(QString const& name) {
+    usbmsDeferClients.remove(name);
+    usbmsDeferWatcher->setWatchedServices(usbmsDeferClients.keys());
+    for (auto it = usbmsDeferred.begin(); it != usbmsDeferred.end();) {
+        if (it->reply.msg.service() == name) {
+            it = usbmsDeferred.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Hold the reply to the current D-Bus call until later
+ * 
+ * Returns \c false if not called from D-Bus, in which case \a reply is
+ * left untouched.
+ */
+bool NDBDbus::ndbDelayReply(NDBDelayedReply& reply) {
+    if (!calledFromDBus()) {
+        return false;
+    }
+    setDelayedReply(true);
+    reply.conn = connection();
+    reply.msg = message();
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Send a previously delayed reply with \a args, if still pending
+ */
+void NDBDbus::ndbSendDelayedReply(NDBDelayedReply& reply, QList<QVariant> const& args) {
+    if (reply.msg.type() != QDBusMessage::MethodCallMessage) {
+        return;
+    }
+    reply.conn.send(reply.msg.createReply(args));
+    reply.msg = QDBusMessage();
+}
+
+/*!
+ * \internal
+ * \brief Send a previously delayed error reply, if still pending
+ */
+void NDBDbus::ndbSendDelayedError(NDBDelayedReply& reply, QDBusError::ErrorType type, QString const& msg) {
+    if (reply.msg.type() != QDBusMessage::MethodCallMessage) {
+        return;
+    }
+    flight.record(NDBFlightRecorder::Error, reply.msg.member().toUtf8(), msg.toUtf8());
+    reply.conn.send(reply.msg.createErrorReply(type, msg));
+    reply.msg = QDBusMessage();
+}
+
 QString NDBDbus::getNickelMetaObjectDetails(const QMetaObject* nmo) {
     QString str = QStringLiteral("");
     str.append(QString("Showing meta information for Nickel class %1 : \n").arg(nmo->className()));
@@ -405,7 +1240,167 @@ QString NDBDbus::ndbFirmwareVersion() {
     return fwVersion;
 }
 
+/*!
+ * \internal
+ * \brief Get the wireless state for the wifiState property
+ */
+QString NDBDbus::propWifiState() {
+    switch (wifiState()) {
+        case NDB_WIFI_DISABLED:   return QStringLiteral("disabled");
+        case NDB_WIFI_ENABLED:    return QStringLiteral("enabled");
+        case NDB_WIFI_CONNECTING: return QStringLiteral("connecting");
+        case NDB_WIFI_CONNECTED:  return QStringLiteral("connected");
+        default:                  return QStringLiteral("unknown");
+    }
+}
+
+/*!
+ * \internal
+ * \brief Summarize the tracked wireless state
+ */
+enum ndb_wifi_state NDBDbus::wifiState() {
+    if (!wmSt.enabledKnown) {
+        return NDB_WIFI_UNKNOWN;
+    } else if (!wmSt.enabled) {
+        return NDB_WIFI_DISABLED;
+    } else if (wmSt.connected) {
+        return NDB_WIFI_CONNECTED;
+    } else if (wmSt.trying) {
+        return NDB_WIFI_CONNECTING;
+    }
+    return NDB_WIFI_ENABLED;
+}
+
+/*!
+ * \internal
+ * \brief Create the state page described in ndb_state.h
+ * 
+ * Clients that poll often can map it, instead of calling methods. It is a
+ * file on tmpfs, as \c /dev/shm isn't always mounted.
+ */
+void NDBDbus::stateOpen() {
+    QObject::connect(this, &NDBDbus::ndbViewChanged, this, [this](QString view) { stateView = view; });
+    QObject::connect(this, &NDBDbus::rvPageChanged, this, [this](int page) { stateBookPage = page; });
+    int fd = open(NDB_STATE_PATH, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0644);
+    if (fd < 0) {
+        nh_log("could not open state page %s: %m", NDB_STATE_PATH);
+        return;
+    }
+    void *map = MAP_FAILED;
+    if (ftruncate(fd, sizeof(struct ndb_state_page)) == 0) {
+        map = mmap(nullptr, sizeof(struct ndb_state_page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        nh_log("could not map state page %s: %m", NDB_STATE_PATH);
+        return;
+    }
+    statePage = static_cast<struct ndb_state_page*>(map);
+    // Clients check the magic first, so fill everything else in before it
+    statePage->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    // A previous instance may have crashed in the middle of an update
+    statePage->seq = 0;
+    statePage->version = NDB_STATE_VERSION;
+    statePage->size = sizeof(struct ndb_state_page);
+    stateUpdate();
+    std::atomic_thread_fence(std::memory_order_release);
+    statePage->magic = NDB_STATE_MAGIC;
+}
+
+/*!
+ * \internal
+ * \brief Copy the current state to the state page
+ */
+void NDBDbus::stateUpdate() {
+    if (!statePage) {
+        return;
+    }
+    uint32_t seq = statePage->seq;
+    __atomic_store_n(&statePage->seq, seq + 1, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+    statePage->event_seq = journalSeq;
+    statePage->updated = QDateTime::currentMSecsSinceEpoch();
+    statePage->page = stateBookPage;
+    statePage->usbms = usbmsActive;
+    statePage->wifi = wifiState();
+    QByteArray view = stateView.toUtf8().left(sizeof(statePage->view) - 1);
+    memset(statePage->view, 0, sizeof(statePage->view));
+    memcpy(statePage->view, view.constData(), view.size());
+    __atomic_store_n(&statePage->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/*!
+ * \internal
+ * \brief Get the connected signals for the connectedSignals property
+ */
+QStringList NDBDbus::propConnectedSignals() {
+    QStringList sigs = connectedSignals.toList();
+    sigs.sort();
+    return sigs;
+}
+
+/*!
+ * \internal
+ * \brief Note that the property \a name may have changed
+ * 
+ * Changes are collected for a short while, so that a burst of them is sent
+ * to clients in a single PropertiesChanged signal.
+ */
+void NDBDbus::propChanged(QString const& name) {
+    propDirty.insert(name);
+    if (!propTimer->isActive()) {
+        propTimer->start();
+    }
+}
+
+/*!
+ * \internal
+ * \brief Emit org.freedesktop.DBus.Properties.PropertiesChanged for the properties
+ * whose value differs from the one last sent
+ */
+void NDBDbus::propEmitChanged() {
+    QVariantMap changed;
+    for (QString const& name : propDirty) {
+        QVariant val = property(name.toLatin1().constData());
+        if (!propSent.contains(name) || propSent.value(name) != val) {
+            propSent.insert(name, val);
+            changed.insert(name, val);
+        }
+    }
+    propDirty.clear();
+    if (changed.isEmpty()) {
+        return;
+    }
+    QDBusMessage sig = QDBusMessage::createSignal(NDB_DBUS_OBJECT_PATH, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("PropertiesChanged"));
+    sig << QStringLiteral(NDB_DBUS_IFACE_NAME) << changed << QStringList();
+    ndbSendSignal(sig);
+}
+
+/*!
+ * \internal
+ * \brief Send \a sig on the system bus and to every peer connection
+ */
+void NDBDbus::ndbSendSignal(QDBusMessage const& sig) {
+    conn.send(sig);
+    for (auto it = peerConns.begin(); it != peerConns.end();) {
+        if (it->isConnected()) {
+            it->send(sig);
+            ++it;
+        } else {
+            it = peerConns.erase(it);
+        }
+    }
+}
+
 #define NDB_DLG_ASSERT(ret, cond) NDB_DBUS_ASSERT(ret, QDBusError::InternalError, cond, (cfmDlg->errString.toUtf8().constData()))
+#define NDB_DLG_MAX_HANDLES 16
+// Looks up the dialog for a handle, or returns an error from the calling method
+#define NDB_DLG_HANDLE(ret, d, handle) NDBCfmDlg *d = dlgHandles.value(handle).dlg; \
+    NDB_DBUS_ASSERT(ret, QDBusError::InvalidArgs, d, "invalid dialog handle %d", handle)
+// The single legacy dialog must not cover a dialog shown through a handle
+#define NDB_DLG_IDLE_ASSERT(ret) NDB_DBUS_ASSERT(ret, QDBusError::LimitsExceeded, !dlgActiveHandle, "dialog %d is being shown", dlgActiveHandle)
+#define NDB_DLG_HANDLE_ASSERT(ret, d, cond) NDB_DBUS_ASSERT(ret, QDBusError::InternalError, cond, (d->errString.toUtf8().constData()))
 
 /*!
  * \internal
@@ -420,6 +1415,7 @@ enum Result NDBDbus::dlgConfirmCreatePreset(QString const& title, QString const&
     if (!acceptText.isEmpty()) { NDB_ASSERT_RES(res, cfmDlg->setAccept(acceptText)); }
     QObject::connect(cfmDlg->dlg, &QDialog::finished, this, &NDBDbus::dlgConfirmResult);
     NDB_ASSERT_RES(res, cfmDlg->showDialog());
+    QObject::connect(cfmDlg->dlg, &QObject::destroyed, this, &NDBDbus::dlgShowNext);
     return Ok;
 }
 
@@ -433,6 +1429,7 @@ enum Result NDBDbus::dlgConfirmCreatePreset(QString const& title, QString const&
  */
 void NDBDbus::dlgConfirmNoBtn(QString const& title, QString const& body) {
     NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_IDLE_ASSERT((void) 0);
     NDB_DLG_ASSERT((void) 0, (dlgConfirmCreatePreset(title, body, "", "") == Ok));
 }
 
@@ -447,6 +1444,7 @@ void NDBDbus::dlgConfirmNoBtn(QString const& title, QString const& body) {
  */
 void NDBDbus::dlgConfirmAccept(QString const& title, QString const& body, QString const& acceptText) {
     NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_IDLE_ASSERT((void) 0);
     NDB_DLG_ASSERT((void) 0, (dlgConfirmCreatePreset(title, body, acceptText, "") == Ok));
 }
 
@@ -461,6 +1459,7 @@ void NDBDbus::dlgConfirmAccept(QString const& title, QString const& body, QStrin
  */
 void NDBDbus::dlgConfirmReject(QString const& title, QString const& body, QString const& rejectText) {
     NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_IDLE_ASSERT((void) 0);
     NDB_DLG_ASSERT((void) 0, (dlgConfirmCreatePreset(title, body, "", rejectText) == Ok));
 }
 
@@ -476,6 +1475,7 @@ void NDBDbus::dlgConfirmReject(QString const& title, QString const& body, QStrin
  */
 void NDBDbus::dlgConfirmAcceptReject(QString const& title, QString const& body, QString const& acceptText, QString const& rejectText) {
     NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_IDLE_ASSERT((void) 0);
     NDB_DLG_ASSERT((void) 0, (dlgConfirmCreatePreset(title, body, acceptText, rejectText) == Ok));
 }
 
@@ -636,6 +1636,46 @@ void NDBDbus::dlgConfirmSetLEPlaceholder(QString const& placeholder) {
     NDB_DLG_ASSERT((void) 0, (cfmDlg->setLEPlaceholder(placeholder) == Ok));
 }
 
+/*!
+ * \brief Open a progress channel for the currently open dialog
+ * 
+ * Returns the write end of a pipe connected to the progress bar of the current
+ * standard dialog. This avoids a method call for every progress update.
+ * 
+ * Each line written to the pipe is a record of the form \c {value[ text]}. \c value
+ * sets the progress bar value, and the optional \c text sets the label format, 
+ * using the same placeholders as \l dlgConfirmSetProgress(). A negative \c value
+ * hides the progress bar. If the progress bar has not been set up yet with
+ * \l dlgConfirmSetProgress(), a range of \c 0 to \c 100 is used. When several
+ * records arrive at once, only the most recent is displayed.
+ * 
+ * If \a closeOnEof is \c true the dialog will be closed when the write end of 
+ * the pipe is closed.
+ * 
+ * From a shell, \c qndb copies its standard input to the returned pipe:
+ * \code
+ * long_running_task | qndb -m dlgConfirmProgressPipe true
+ * \endcode
+ * where \c long_running_task periodically does something like
+ * \c {echo "75 Copying %p%"}.
+ * 
+ * \since 0.4.0
+ */
+QDBusUnixFileDescriptor NDBDbus::dlgConfirmProgressPipe(bool closeOnEof) {
+    QDBusUnixFileDescriptor fd;
+    NDB_DBUS_USB_ASSERT(fd);
+    NDB_DBUS_ASSERT(fd, QDBusError::NotSupported, 
+        !calledFromDBus() || (connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing), 
+        "connection does not support passing file descriptors");
+    int writeFd;
+    NDB_DLG_ASSERT(fd, (cfmDlg->openProgressPipe(closeOnEof, &writeFd) == Ok));
+    // QDBusUnixFileDescriptor keeps its own duplicate, ours must be closed so
+    // the read end sees EOF once the client is done with it.
+    fd.setFileDescriptor(writeFd);
+    close(writeFd);
+    return fd;
+}
+
 /*!
  * \brief Display the current dialog
  * 
@@ -643,7 +1683,10 @@ void NDBDbus::dlgConfirmSetLEPlaceholder(QString const& placeholder) {
  */
 void NDBDbus::dlgConfirmShow() {
     NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_IDLE_ASSERT((void) 0);
     NDB_DLG_ASSERT((void) 0, (cfmDlg->showDialog() == Ok));
+    // Handle dialogs queued in the meantime wait for this one to go away
+    QObject::connect(cfmDlg->dlg, &QObject::destroyed, this, &NDBDbus::dlgShowNext, Qt::UniqueConnection);
 }
 
 /*!
@@ -654,9 +1697,512 @@ void NDBDbus::dlgConfirmShow() {
  * 
  * \since 0.2.0
  */
-void NDBDbus::dlgConfirmClose() {
-    NDB_DBUS_USB_ASSERT((void) 0);
-    NDB_DLG_ASSERT((void) 0, (cfmDlg->closeDialog() == Ok));
+void NDBDbus::dlgConfirmClose() {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_ASSERT((void) 0, (cfmDlg->closeDialog() == Ok));
+}
+
+/*!
+ * \brief Show a dialog built from a form description, and return all values at once
+ * 
+ * \a form is a JSON object describing the dialog. It may contain \c title, 
+ * \c accept and \c reject strings, an integer \c priority (see \l dlgCreate()),
+ * and a \c fields array. Each field is an object with a \c type, a \c name used
+ * as the key in the result, and an optional \c label. The following field types
+ * are supported:
+ * 
+ * \list
+ *   \li \c label - static text set with \c text
+ *   \li \c lineedit - text input. Optional \c text, \c placeholder and \c password
+ *   \li \c checkbox - optional boolean \c checked
+ *   \li \c choice - a list of \c options to choose one from, with an optional 
+ *       \c selected index
+ *   \li \c progress - a progress bar with optional \c min, \c max, \c value and
+ *       \c format
+ * \endlist
+ * 
+ * For example:
+ * \code
+ * {"title": "Connect", "accept": "Save", "reject": "Cancel", "fields": [
+ *     {"type": "lineedit", "name": "host", "label": "Host", "placeholder": "example.com"},
+ *     {"type": "checkbox", "name": "tls", "label": "Use TLS", "checked": true},
+ *     {"type": "choice", "name": "mode", "label": "Mode", "options": ["push", "pull"], "selected": 0}
+ * ]}
+ * \endcode
+ * 
+ * The form is queued behind any other dialog that is currently shown. If the form 
+ * has a positive \c timeout (in milliseconds), it is rejected once that much time 
+ * has passed without an answer. The reply 
+ * is sent once the user accepts or rejects it. It is a JSON object with the dialog
+ * \c result (\c 1 for ACCEPT or \c 0 for REJECT) and the \c values of every named field:
+ * \code
+ * {"result": 1, "values": {"host": "example.com", "mode": "push", "tls": true}}
+ * \endcode
+ * 
+ * \note Callers should use a method call timeout long enough for the user to
+ * fill in the form.
+ * 
+ * \since 0.4.0
+ */
+QString NDBDbus::dlgConfirmForm(QString const& form) {
+    QString ret;
+    NDB_DBUS_USB_ASSERT(ret);
+    NDB_DBUS_ASSERT(ret, QDBusError::LimitsExceeded, dlgHandles.size() < NDB_DLG_MAX_HANDLES, "too many open dialogs");
+    QJsonParseError err;
+    QJsonDocument doc = QJsonDocument::fromJson(form.toUtf8(), &err);
+    NDB_DBUS_ASSERT(ret, QDBusError::InvalidArgs, doc.isObject(), "invalid form description: %s", err.errorString().toUtf8().constData());
+    QVariantMap desc = doc.object().toVariantMap();
+    NDB_DBUS_ASSERT(ret, QDBusError::InvalidArgs, desc.value("timeout").toInt() >= 0, "timeout must not be negative");
+    NDBCfmDlg *d = new NDBCfmDlg(this);
+    dlgStartDelayed(d, d->createForm(desc), desc.value("priority").toInt(), desc.value("timeout").toInt());
+    return ret;
+}
+
+/*!
+ * \brief Create a flexible confirmation dialog, and return a handle to it
+ * 
+ * Works like \l dlgConfirmCreate(), except that any number of dialogs may exist
+ * at the same time. Each one is identified by the returned handle, which is
+ * passed to the other \c dlg* methods taking a \c handle argument. If 
+ * \a createLineEdit is \c true a LineEdit dialog will be created, otherwise a 
+ * standard dialog is created.
+ * 
+ * Dialogs are displayed one at a time. Calling \l dlgShow() queues the dialog,
+ * and it is shown once every dialog ahead of it has closed. Dialogs with a higher
+ * \a priority are shown before those with a lower one, and dialogs with the same
+ * priority are shown in the order \l dlgShow() was called.
+ * 
+ * When the dialog is closed, \l dlgResult() is emitted with the handle and result.
+ * For a LineEdit dialog, \l dlgTextInput() is emitted first, with the contents of
+ * the text edit field if the dialog was accepted, or an empty string otherwise.
+ * The handle is no longer valid once the dialog has been closed. Dialogs are
+ * closed when the client that created them disconnects from the bus.
+ * 
+ * \since 0.4.0
+ */
+int NDBDbus::dlgCreate(bool createLineEdit, int priority) {
+    NDB_DBUS_USB_ASSERT(0);
+    NDB_DBUS_ASSERT(0, QDBusError::LimitsExceeded, dlgHandles.size() < NDB_DLG_MAX_HANDLES, "too many open dialogs");
+    NDBCfmDlg *d = new NDBCfmDlg(this);
+    if (d->createDialog(createLineEdit ? NDBCfmDlg::TypeLineEdit : NDBCfmDlg::TypeStd) != Ok) {
+        QString errString = d->errString;
+        delete d;
+        NDB_DBUS_ASSERT(0, QDBusError::InternalError, false, "%s", errString.toUtf8().constData());
+    }
+    return dlgAddHandle(d, priority);
+}
+
+/*!
+ * \brief Set title of the dialog identified by \a handle to \a title
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetTitle(int handle, QString const& title) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setTitle(title) == Ok));
+}
+
+/*!
+ * \brief Set body text of the dialog identified by \a handle to \a body
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetBody(int handle, QString const& body) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setBody(body) == Ok));
+}
+
+/*!
+ * \brief Set the accept button of the dialog identified by \a handle
+ * 
+ * The accept button will be enabled, and its label will be set
+ * to \a acceptText
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetAccept(int handle, QString const& acceptText) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setAccept(acceptText) == Ok));
+}
+
+/*!
+ * \brief Set the reject button of the dialog identified by \a handle
+ * 
+ * The reject button will be enabled, and its label will be set
+ * to \a rejectText
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetReject(int handle, QString const& rejectText) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setReject(rejectText) == Ok));
+}
+
+/*!
+ * \brief Set whether the dialog identified by \a handle will be modal
+ * 
+ * See \l dlgConfirmSetModal() for the meaning of \a modal.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetModal(int handle, bool modal) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setModal(modal) == Ok));
+}
+
+/*!
+ * \brief Set whether the dialog identified by \a handle will have a close button
+ * 
+ * See \l dlgConfirmShowClose() for the meaning of \a show.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgShowClose(int handle, bool show) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->showClose(show) == Ok));
+}
+
+/*!
+ * \brief Display a progress bar on the dialog identified by \a handle
+ * 
+ * \a min, \a max, \a val and \a format work the same as for
+ * \l dlgConfirmSetProgress().
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetProgress(int handle, int min, int max, int val, QString const& format) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setProgress(min, max, val, format) == Ok));
+}
+
+/*!
+ * \brief Sets whether the line edit dialog identified by \a handle is a password dialog
+ * 
+ * See \l dlgConfirmSetLEPassword() for the meaning of \a password.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetLEPassword(int handle, bool password) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setLEPassword(password) == Ok));
+}
+
+/*!
+ * \brief Set the placeholder of the line edit dialog identified by \a handle to \a placeholder
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgSetLEPlaceholder(int handle, QString const& placeholder) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->setLEPlaceholder(placeholder) == Ok));
+}
+
+/*!
+ * \brief Open a progress channel for the dialog identified by \a handle
+ * 
+ * Works like \l dlgConfirmProgressPipe(), including the meaning of \a closeOnEof.
+ * 
+ * \since 0.4.0
+ */
+QDBusUnixFileDescriptor NDBDbus::dlgProgressPipe(int handle, bool closeOnEof) {
+    QDBusUnixFileDescriptor fd;
+    NDB_DBUS_USB_ASSERT(fd);
+    NDB_DBUS_ASSERT(fd, QDBusError::NotSupported, 
+        !calledFromDBus() || (connection().connectionCapabilities() & QDBusConnection::UnixFileDescriptorPassing), 
+        "connection does not support passing file descriptors");
+    NDB_DLG_HANDLE(fd, d, handle);
+    int writeFd;
+    NDB_DLG_HANDLE_ASSERT(fd, d, (d->openProgressPipe(closeOnEof, &writeFd) == Ok));
+    fd.setFileDescriptor(writeFd);
+    close(writeFd);
+    return fd;
+}
+
+/*!
+ * \brief Queue the dialog identified by \a handle to be shown
+ * 
+ * The dialog is shown straight away if no other dialog is being displayed.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgShow(int handle) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, handle != dlgActiveHandle && !dlgQueue.contains(handle), "dialog %d already shown", handle);
+    dlgEnqueue(handle);
+}
+
+/*!
+ * \brief Close the dialog identified by \a handle
+ * 
+ * If the dialog is still waiting to be shown, it is removed from the queue
+ * and \l dlgResult() is emitted with a result of \c 0.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::dlgClose(int handle) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DLG_HANDLE((void) 0, d, handle);
+    if (handle != dlgActiveHandle) {
+        dlgHandleFinished(handle, QDialog::Rejected);
+        return;
+    }
+    NDB_DLG_HANDLE_ASSERT((void) 0, d, (d->closeDialog() == Ok));
+}
+
+/*!
+ * \brief Show a confirmation dialog, and reply once the user has answered it
+ * 
+ * Create a dialog with \a title and \a body, and optional \a acceptText and 
+ * \a rejectText buttons. Unlike \l dlgConfirmAcceptReject(), the method call
+ * does not return until the dialog is dismissed, and the reply is the result 
+ * (\c 1 for ACCEPT or \c 0 for REJECT).
+ * 
+ * The dialog is queued behind any other dialog that is currently shown. If 
+ * \a timeout is greater than \c 0, the dialog is rejected once \a timeout 
+ * milliseconds have passed without an answer.
+ * 
+ * \note Callers should use a method call timeout longer than \a timeout, or
+ * long enough for the user to answer.
+ * 
+ * \since 0.4.0
+ */
+int NDBDbus::dlgPromptConfirm(QString const& title, QString const& body, QString const& acceptText, QString const& rejectText, int timeout) {
+    NDB_DBUS_USB_ASSERT(0);
+    NDB_DBUS_ASSERT(0, QDBusError::LimitsExceeded, dlgHandles.size() < NDB_DLG_MAX_HANDLES, "too many open dialogs");
+    NDB_DBUS_ASSERT(0, QDBusError::InvalidArgs, timeout >= 0, "timeout must not be negative");
+    NDBCfmDlg *d = new NDBCfmDlg(this);
+    enum Result res = d->createDialog(NDBCfmDlg::TypeStd);
+    if (res == Ok && !title.isEmpty()) { res = d->setTitle(title); }
+    if (res == Ok && !body.isEmpty()) { res = d->setBody(body); }
+    if (res == Ok && !rejectText.isEmpty()) { res = d->setReject(rejectText); }
+    if (res == Ok && !acceptText.isEmpty()) { res = d->setAccept(acceptText); }
+    dlgStartDelayed(d, res, 0, timeout);
+    return 0;
+}
+
+/*!
+ * \brief Ask the user for a line of text, and reply with it once they have answered
+ * 
+ * Create a line edit dialog with \a title, and \a placeholder text. The method
+ * call does not return until the dialog is dismissed. The reply is the result 
+ * (\c 1 for ACCEPT or \c 0 for REJECT) followed by the entered \a text, which 
+ * is empty if the dialog was rejected.
+ * 
+ * \a timeout works the same as for \l dlgPromptConfirm().
+ * 
+ * \since 0.4.0
+ */
+int NDBDbus::dlgPromptText(QString const& title, QString const& placeholder, int timeout, QString& text) {
+    text = QString();
+    return dlgPromptLineEdit(title, placeholder, false, timeout);
+}
+
+/*!
+ * \brief Ask the user for a password, and reply with it once they have answered
+ * 
+ * Works like \l dlgPromptText(), except that the entered \a text is masked
+ * unless the user taps the 'show password' checkbox. \a title, \a placeholder
+ * and \a timeout are the same as for \l dlgPromptText().
+ * 
+ * \since 0.4.0
+ */
+int NDBDbus::dlgPromptPassword(QString const& title, QString const& placeholder, int timeout, QString& text) {
+    text = QString();
+    return dlgPromptLineEdit(title, placeholder, true, timeout);
+}
+
+/*!
+ * \internal
+ * \brief Create and queue a line edit dialog whose result is sent as the method reply
+ */
+int NDBDbus::dlgPromptLineEdit(QString const& title, QString const& placeholder, bool password, int timeout) {
+    NDB_DBUS_USB_ASSERT(0);
+    NDB_DBUS_ASSERT(0, QDBusError::LimitsExceeded, dlgHandles.size() < NDB_DLG_MAX_HANDLES, "too many open dialogs");
+    NDB_DBUS_ASSERT(0, QDBusError::InvalidArgs, timeout >= 0, "timeout must not be negative");
+    NDBCfmDlg *d = new NDBCfmDlg(this);
+    enum Result res = d->createDialog(NDBCfmDlg::TypeLineEdit);
+    if (res == Ok && !title.isEmpty()) { res = d->setTitle(title); }
+    if (res == Ok && !placeholder.isEmpty()) { res = d->setLEPlaceholder(placeholder); }
+    if (res == Ok) { res = d->setLEPassword(password); }
+    dlgStartDelayed(d, res, 0, timeout);
+    return 0;
+}
+
+/*!
+ * \internal
+ * \brief Queue the dialog \a d, and reply to the current method call once it is dismissed
+ * 
+ * \a res is the result of setting up the dialog. If it isn't \c Ok, the dialog is
+ * discarded and an error is sent instead.
+ */
+void NDBDbus::dlgStartDelayed(NDBCfmDlg *d, enum Result res, int priority, int timeout) {
+    if (res != Ok) {
+        QString errString = d->errString;
+        if (d->dlg) {
+            d->dlg->deleteLater();
+        }
+        delete d;
+        NDB_DBUS_ASSERT((void) 0, QDBusError::InternalError, false, "%s", errString.toUtf8().constData());
+    }
+    int handle = dlgAddHandle(d, priority);
+    ndbDelayReply(dlgHandles[handle].reply);
+    if (timeout > 0) {
+        QTimer *t = new QTimer(d);
+        t->setSingleShot(true);
+        QObject::connect(t, &QTimer::timeout, this, [this, handle]() { dlgTimedOut(handle); });
+        t->start(timeout);
+    }
+    dlgEnqueue(handle);
+}
+
+/*!
+ * \internal
+ * \brief Reject the dialog identified by \a handle, whether it is shown or still queued
+ */
+void NDBDbus::dlgTimedOut(int handle) {
+    NDBCfmDlg *d = dlgHandles.value(handle).dlg;
+    if (d && d->dlg && handle == dlgActiveHandle) {
+        d->dlg->reject();
+    } else {
+        dlgHandleFinished(handle, QDialog::Rejected);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Close the dialogs created by bus name \a name, which has disconnected
+ */
+void NDBDbus::onDlgOwnerGone(QString const& name) {
+    QList<int> owned;
+    for (auto it = dlgHandles.constBegin(); it != dlgHandles.constEnd(); ++it) {
+        if (it->owner == name) {
+            owned.append(it.key());
+        }
+    }
+    for (int handle : owned) {
+        nh_log("closing dialog %d of %s", handle, name.toUtf8().constData());
+        dlgTimedOut(handle);
+    }
+    dlgOwnerWatcher->removeWatchedService(name);
+}
+
+/*!
+ * \internal
+ * \brief Take ownership of the dialog \a d, and return the handle it is identified by
+ */
+int NDBDbus::dlgAddHandle(NDBCfmDlg *d, int priority) {
+    int handle = dlgNextHandle;
+    dlgNextHandle = (dlgNextHandle == INT_MAX) ? 1 : dlgNextHandle + 1;
+    DlgHandle& h = dlgHandles[handle];
+    h.dlg = d;
+    h.priority = priority;
+    // Handles are released when the client that created them goes away
+    h.owner = calledFromDBus() ? message().service() : QString();
+    if (!h.owner.isEmpty()) {
+        dlgOwnerWatcher->addWatchedService(h.owner);
+    }
+    if (d->activeType() == NDBCfmDlg::TypeStd) {
+        QObject::connect(d->dlg, &QDialog::finished, this, [this, handle](int result) { dlgHandleFinished(handle, result); });
+    } else {
+        // Dialogs created by 'showTextEditDialog()' may emit accepted() 
+        // without going through finished()
+        QObject::connect(d->dlg, &QDialog::accepted, this, [this, handle]() { dlgHandleFinished(handle, QDialog::Accepted); });
+        QObject::connect(d->dlg, &QDialog::rejected, this, [this, handle]() { dlgHandleFinished(handle, QDialog::Rejected); });
+    }
+    QObject::connect(d->dlg, &QObject::destroyed, this, [this, handle]() { dlgHandleFinished(handle, QDialog::Rejected); });
+    return handle;
+}
+
+/*!
+ * \internal
+ * \brief Insert \a handle into the display queue according to its priority
+ */
+void NDBDbus::dlgEnqueue(int handle) {
+    int priority = dlgHandles.value(handle).priority;
+    int i = 0;
+    while (i < dlgQueue.size() && dlgHandles.value(dlgQueue.at(i)).priority >= priority) {
+        ++i;
+    }
+    dlgQueue.insert(i, handle);
+    dlgShowNext();
+}
+
+/*!
+ * \internal
+ * \brief Show the next queued dialog, unless one is already being displayed
+ */
+void NDBDbus::dlgShowNext() {
+    if (dlgActiveHandle || (cfmDlg->dlg && cfmDlg->dlg->isVisible())) {
+        return;
+    }
+    while (!dlgQueue.isEmpty()) {
+        int handle = dlgQueue.takeFirst();
+        NDBCfmDlg *d = dlgHandles.value(handle).dlg;
+        if (d && d->showDialog() == Ok) {
+            dlgActiveHandle = handle;
+            return;
+        }
+        nh_log("unable to show dialog %d", handle);
+        dlgHandleFinished(handle, QDialog::Rejected);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Report the \a result of the dialog identified by \a handle, and release it
+ */
+void NDBDbus::dlgHandleFinished(int handle, int result) {
+    if (!dlgHandles.contains(handle)) {
+        return;
+    }
+    DlgHandle h = dlgHandles.take(handle);
+    dlgQueue.removeAll(handle);
+    if (!h.owner.isEmpty()) {
+        bool ownsMore = false;
+        for (DlgHandle const& o : dlgHandles) {
+            ownsMore = ownsMore || o.owner == h.owner;
+        }
+        if (!ownsMore) {
+            dlgOwnerWatcher->removeWatchedService(h.owner);
+        }
+    }
+    NDBCfmDlg *d = h.dlg;
+    if (d->dlg) {
+        QObject::disconnect(d->dlg, nullptr, this, nullptr);
+    }
+    // Dialogs created by a method call that is waiting on the result get their reply
+    if (d->activeType() == NDBCfmDlg::TypeStd) {
+        ndbSendDelayedReply(h.reply, QList<QVariant>() << result);
+    } else if (d->activeType() == NDBCfmDlg::TypeLineEdit) {
+        QString text = (result == QDialog::Accepted) ? d->getLEText() : QString("");
+        ndbSendDelayedReply(h.reply, QList<QVariant>() << result << text);
+        emit dlgTextInput(handle, text);
+    } else if (d->activeType() == NDBCfmDlg::TypeForm) {
+        QJsonObject res;
+        res.insert("result", result);
+        res.insert("values", QJsonObject::fromVariantMap(d->getFormValues()));
+        ndbSendDelayedReply(h.reply, QList<QVariant>() << QString::fromUtf8(QJsonDocument(res).toJson(QJsonDocument::Compact)));
+    }
+    emit dlgResult(handle, result);
+    if (d->dlg) {
+        d->dlg->deleteLater();
+    }
+    d->deleteLater();
+    if (dlgActiveHandle == handle) {
+        dlgActiveHandle = 0;
+        // Let the closing dialog go away before the next one appears
+        QTimer::singleShot(0, this, SLOT(dlgShowNext()));
+    }
 }
 
 /*!
@@ -677,20 +2223,116 @@ void NDBDbus::onDlgLineEditRejected() {
     emit dlgConfirmResult(QDialog::Rejected);
 }
 
+#define NDB_TOAST_MIN_TIME 1000
+#define NDB_TOAST_MAX_QUEUED 32
+
 /*!
  * \brief Show a small, temporary text box with a message 
  * 
  * Show a text box on screen for \a toastDuration duration (in milliseconds)
- * with \a msgMain as the body text, and an optional \a msgSub
+ * with \a msgMain as the body text, and an optional \a msgSub. Toasts stay on
+ * screen for at least one second, even if \a toastDuration is shorter.
+ * 
+ * Toasts are queued and shown one after the other, so that they don't 
+ * overwrite each other. A toast identical to one that is already waiting, or 
+ * currently being shown, is merged with it instead of being shown again.
  */
 void NDBDbus::mwcToast(int toastDuration, QString const &msgMain, QString const &msgSub) {
     NDB_DBUS_USB_ASSERT((void) 0);
-    // The following code has been adapted from NickelMenu
-    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, toastDuration > 0 && toastDuration <= 5000, "toast duration must be between 0 and 5000 miliseconds");
+    Toast t;
+    t.duration = toastDuration;
+    t.msgMain = msgMain;
+    t.msgSub = msgSub;
+    toastEnqueue(t);
+}
+
+/*!
+ * \brief Show a toast that replaces any other toast with the same key
+ * 
+ * Works like \l mwcToast() for \a toastDuration, \a msgMain and \a msgSub,
+ * except that if a toast with the same \a key is already being shown or is 
+ * waiting to be shown, it is updated with the new message instead of a new toast
+ * being added. This is useful for progress messages, such as "Syncing 40%".
+ * 
+ * An update to the toast currently on screen is shown once it has been visible
+ * for at least one second, to limit screen refreshes. Only the latest update 
+ * is kept.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::mwcToastReplace(QString const& key, int toastDuration, QString const& msgMain, QString const& msgSub) {
+    NDB_DBUS_USB_ASSERT((void) 0);
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, !key.isEmpty(), "key must not be empty");
+    Toast t;
+    t.key = key;
+    t.duration = toastDuration;
+    t.msgMain = msgMain;
+    t.msgSub = msgSub;
+    toastEnqueue(t);
+}
+
+/*!
+ * \internal
+ * \brief Add toast \a t to the queue, merging it with an existing toast where possible
+ */
+void NDBDbus::toastEnqueue(Toast const& t) {
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, t.duration > 0 && t.duration <= 5000, "toast duration must be between 0 and 5000 miliseconds");
     NDB_DBUS_SYM_ASSERT((void) 0, nSym.MainWindowController_sharedInstance && nSym.MainWindowController_toast);
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InternalError, nSym.MainWindowController_sharedInstance(), "could not get MainWindowController instance");
+    bool showing = toastTimer->isActive();
+    auto same = [&t](Toast const& o) {
+        return t.key.isEmpty() ? (o.key.isEmpty() && o.msgMain == t.msgMain && o.msgSub == t.msgSub) : (o.key == t.key);
+    };
+    if (showing && t.key.isEmpty() && same(toastCurrent)) {
+        return;
+    }
+    for (Toast& q : toastQueue) {
+        if (same(q)) {
+            q.msgMain = t.msgMain;
+            q.msgSub = t.msgSub;
+            q.duration = qMax(q.duration, t.duration);
+            return;
+        }
+    }
+    NDB_DBUS_ASSERT((void) 0, QDBusError::LimitsExceeded, toastQueue.size() < NDB_TOAST_MAX_QUEUED, "too many toasts queued");
+    if (showing && !t.key.isEmpty() && same(toastCurrent)) {
+        // Update the toast on screen as soon as it has been visible long enough
+        toastQueue.prepend(t);
+        int wait = qMax(0, NDB_TOAST_MIN_TIME - (int) toastShown.elapsed());
+        if (wait < toastTimer->remainingTime()) {
+            toastTimer->start(wait);
+        }
+        return;
+    }
+    toastQueue.append(t);
+    if (!showing) {
+        toastShowNext();
+    }
+}
+
+/*!
+ * \internal
+ * \brief Show the next queued toast, once the current one has been displayed
+ */
+void NDBDbus::toastShowNext() {
+    toastCurrent = Toast();
+    if (toastQueue.isEmpty()) {
+        return;
+    }
+    // The following code has been adapted from NickelMenu
     MainWindowController *mwc = nSym.MainWindowController_sharedInstance();
-    NDB_DBUS_ASSERT((void) 0, QDBusError::InternalError, mwc, "could not get MainWindowController instance");
-    nSym.MainWindowController_toast(mwc, msgMain, msgSub, toastDuration);
+    if (!mwc) {
+        nh_log("could not get MainWindowController instance, dropping %d toasts", toastQueue.size());
+        toastQueue.clear();
+        return;
+    }
+    toastCurrent = toastQueue.takeFirst();
+    // Nickel is asked for the same time the queue waits, so a short toast
+    // doesn't vanish before the next one is due
+    int duration = qMax(toastCurrent.duration, NDB_TOAST_MIN_TIME);
+    nSym.MainWindowController_toast(mwc, toastCurrent.msgMain, toastCurrent.msgSub, duration);
+    toastShown.start();
+    toastTimer->start(duration);
 }
 
 /*!
@@ -784,13 +2426,164 @@ void NDBDbus::n3fssSync(QStringList* paths) {
 }
 
 void NDBDbus::ndbNickelMisc(const char *action) {
-    nm_action_result_t *res = nm_action_nickel_misc(action);
+    ndbNmAction("nm_action_nickel_misc", nm_action_nickel_misc, action);
+}
+
+// Every action NickelMenu provides, by the name used in its config files
+static const struct {
+    const char *name;
+    nm_action_fn_t fn;
+} nmActionTable[] = {
+    #define X(name) {#name, NM_ACTION(name)},
+    NM_ACTIONS
+    #undef X
+};
+
+static nm_action_fn_t nmActionFn(QString const& type) {
+    for (auto const& a : nmActionTable) {
+        if (type == QLatin1String(a.name)) {
+            return a.fn;
+        }
+    }
+    return nullptr;
+}
+
+/*!
+ * \internal
+ * \brief Check whether the caller may run NickelMenu action \a fn
+ * 
+ * The command actions run arbitrary programs as root, so they are only 
+ * allowed for callers that are already root.
+ */
+bool NDBDbus::ndbNmActionAllowed(nm_action_fn_t fn) {
+    if (fn != NM_ACTION(cmd_spawn) && fn != NM_ACTION(cmd_output)) {
+        return true;
+    }
+    if (!calledFromDBus()) {
+        return true;
+    }
+    QDBusReply<uint> uid = connection().interface()->serviceUid(message().service());
+    return uid.isValid() && uid.value() == 0;
+}
+
+/*!
+ * \internal
+ * \brief Run a NickelMenu action
+ * 
+ * Returns \c true if the action succeeded, with its message (if any) in \a msg.
+ * Otherwise \a msg is set to the error. If \a skip is not null, it is set to the
+ * number of following actions a \c skip action asked to skip.
+ */
+bool NDBDbus::ndbRunNmAction(nm_action_fn_t fn, const char *arg, QString& msg, int *skip) {
+    nm_action_result_t *res = fn(arg);
+    if (skip) {
+        *skip = 0;
+    }
     if (!res) {
-        nh_log("nm_action_nickel_misc failed with error: %s", nm_err_peek());
-        sendErrorReply(QDBusError::InternalError, QString("nm_action_nickel_misc failed with error: %1").arg(nm_err()));
-        return;
+        msg = QString::fromUtf8(nm_err());
+        return false;
+    }
+    msg = res->msg ? QString::fromUtf8(res->msg) : QString();
+    if (skip && res->type == NM_ACTION_RESULT_TYPE_SKIP) {
+        *skip = res->skip;
     }
     nm_action_result_free(res);
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief Run a NickelMenu action, replying with an error named after \a name if it fails
+ */
+void NDBDbus::ndbNmAction(const char *name, nm_action_fn_t fn, const char *arg) {
+    QString msg;
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InternalError, ndbRunNmAction(fn, arg, msg), "%s failed with error: %s", name, msg.toUtf8().constData());
+}
+
+/*!
+ * \brief Run any NickelMenu action
+ * 
+ * Runs the NickelMenu action \a type with the argument \a arg, exactly as if it 
+ * were a menu item in a NickelMenu config file (\c {menu_item:main:Label:type:arg}).
+ * Every action type NickelMenu provides is supported, except \c skip, which is only
+ * meaningful in \l nmChain().
+ * 
+ * Returns the message the action produced, if any. For example, \c cmd_output
+ * returns the output of the command. Messages are returned rather than shown on
+ * screen.
+ * 
+ * The \c cmd_spawn and \c cmd_output actions run commands as root, so they 
+ * are refused with an \c AccessDenied error unless the caller is also root.
+ * 
+ * \since 0.4.0
+ */
+QString NDBDbus::nmAction(QString const& type, QString const& arg) {
+    QString msg;
+    NDB_DBUS_USB_ASSERT(msg);
+    nm_action_fn_t fn = nmActionFn(type);
+    NDB_DBUS_ASSERT(msg, QDBusError::InvalidArgs, fn, "unknown action type '%s'", type.toUtf8().constData());
+    NDB_DBUS_ASSERT(msg, QDBusError::InvalidArgs, fn != NM_ACTION(skip), "skip can only be used in a chain");
+    NDB_DBUS_ASSERT(msg, QDBusError::AccessDenied, ndbNmActionAllowed(fn), "%s is only allowed for root", type.toUtf8().constData());
+    QByteArray argBytes = arg.toUtf8();
+    NDB_DBUS_ASSERT(QString(), QDBusError::InternalError, ndbRunNmAction(fn, argBytes.constData(), msg), "%s failed with error: %s", type.toUtf8().constData(), msg.toUtf8().constData());
+    return msg;
+}
+
+/*!
+ * \brief Run a sequence of NickelMenu actions in one call
+ * 
+ * Each entry of \a actions is an action in the form \c {type:arg}, using the 
+ * same types and arguments as \l nmAction(). The actions are run in order, like
+ * a NickelMenu \c chain. A \c skip action skips the given number of following
+ * actions, or all of them if the number is \c -1.
+ * 
+ * If \a stopOnError is \c true, the actions following one that failed are not
+ * run. Otherwise the chain carries on regardless.
+ * 
+ * Returns one result per action, in the same order. Each result is one of 
+ * \c {ok:message}, \c {error:message} or \c {skipped:}, where \c message
+ * may be empty.
+ * 
+ * Every action type is checked before any action is run, so a typo does not
+ * leave a chain half done. As with \l nmAction(), a chain containing 
+ * \c cmd_spawn or \c cmd_output is refused unless the caller is root.
+ * 
+ * \since 0.4.0
+ */
+QStringList NDBDbus::nmChain(QStringList const& actions, bool stopOnError) {
+    QStringList results;
+    NDB_DBUS_USB_ASSERT(results);
+    QList<nm_action_fn_t> fns;
+    QList<QByteArray> args;
+    for (int i = 0; i < actions.size(); ++i) {
+        int sep = actions.at(i).indexOf(':');
+        QString type = actions.at(i).left(sep).trimmed();
+        nm_action_fn_t fn = nmActionFn(type);
+        NDB_DBUS_ASSERT(results, QDBusError::InvalidArgs, fn, "action %d: unknown action type '%s'", i + 1, type.toUtf8().constData());
+        NDB_DBUS_ASSERT(results, QDBusError::AccessDenied, ndbNmActionAllowed(fn), "action %d: %s is only allowed for root", i + 1, type.toUtf8().constData());
+        fns.append(fn);
+        args.append(sep < 0 ? QByteArray("") : actions.at(i).mid(sep + 1).toUtf8());
+    }
+    int skip = 0;
+    bool stopped = false;
+    for (int i = 0; i < fns.size(); ++i) {
+        if (stopped || skip != 0) {
+            results.append("skipped:");
+            if (skip > 0) {
+                --skip;
+            }
+            continue;
+        }
+        QString msg;
+        if (ndbRunNmAction(fns.at(i), args.at(i).constData(), msg, &skip)) {
+            results.append(QString("ok:%1").arg(msg));
+        } else {
+            nh_log("nmChain: action %d failed with error: %s", i + 1, msg.toUtf8().constData());
+            results.append(QString("error:%1").arg(msg));
+            stopped = stopOnError;
+        }
+    }
+    return results;
 }
 
 bool NDBDbus::ndbActionStrValid(QString const& actStr) {
@@ -831,14 +2624,120 @@ void NDBDbus::wfmSetAirplaneMode(QString const& action) {
     return ndbWireless(actBytes.constData());
 }
 
-void NDBDbus::ndbWireless(const char *act) {
-    nm_action_result_t *res = nm_action_nickel_wifi(act);
-    if (!res) {
-        nh_log("ndbWireless failed with error: %s", nm_err_peek());
-        sendErrorReply(QDBusError::InternalError, QString("ndbWireless failed with error: %1").arg(nm_err()));
-        return;
+/*!
+ * \brief Get the last known state of the wireless connection
+ * 
+ * NickelDBus keeps track of the WirelessManager signals, so the current state
+ * can be queried without waiting for a signal. The returned map has the 
+ * following keys:
+ * 
+ * \list
+ *   \li \c enabled - \c true if WiFi is enabled
+ *   \li \c connected - \c true if connected to a network
+ *   \li \c trying - \c true while trying to connect to a network
+ *   \li \c scanning - \c true while scanning for networks
+ *   \li \c linkQuality - the last reported link quality of the connected network
+ *   \li \c macAddress - the MAC address of the wireless adapter
+ *   \li \c connectedMs - how long the current connection has been up, in milliseconds
+ *   \li \c lastEvent - the name of the last wireless signal, such as \c networkConnected
+ *   \li \c lastEventMs - how long ago \c lastEvent happened, in milliseconds
+ * \endlist
+ * 
+ * Keys whose value has not been reported by Nickel since NickelDBus started
+ * are left out.
+ * 
+ * \since 0.4.0
+ */
+QVariantMap NDBDbus::wmState() {
+    QVariantMap st;
+    if (wmSt.enabledKnown) {
+        st.insert("enabled", wmSt.enabled);
     }
-    nm_action_result_free(res);
+    st.insert("connected", wmSt.connected);
+    st.insert("trying", wmSt.trying);
+    st.insert("scanning", wmSt.scanning);
+    if (wmSt.linkQuality >= 0.0) {
+        st.insert("linkQuality", wmSt.linkQuality);
+    }
+    if (!wmSt.macAddress.isEmpty()) {
+        st.insert("macAddress", wmSt.macAddress);
+    }
+    if (wmSt.connected && wmSt.connectedSince.isValid()) {
+        st.insert("connectedMs", (qlonglong) wmSt.connectedSince.elapsed());
+    }
+    if (wmSt.lastChange.isValid()) {
+        st.insert("lastEvent", wmSt.lastEvent);
+        st.insert("lastEventMs", (qlonglong) wmSt.lastChange.elapsed());
+    }
+    return st;
+}
+
+/*!
+ * \internal
+ * \brief Keep the wireless state up to date from our own relayed WirelessManager signals
+ */
+void NDBDbus::wmTrackState() {
+    QObject::connect(this, &NDBDbus::wmTryingToConnect, this, [this]() {
+        wmSt.trying = true;
+        wmTransition("tryingToConnect");
+    });
+    QObject::connect(this, &NDBDbus::wmNetworkConnected, this, [this]() {
+        wmSt.enabledKnown = wmSt.enabled = true;
+        wmSt.connected = true;
+        wmSt.trying = false;
+        wmSt.connectedSince.start();
+        wmTransition("networkConnected");
+    });
+    QObject::connect(this, &NDBDbus::wmNetworkDisconnected, this, [this]() {
+        wmSt.connected = wmSt.trying = false;
+        wmSt.linkQuality = -1.0;
+        wmTransition("networkDisconnected");
+    });
+    QObject::connect(this, &NDBDbus::wmNetworkForgotten, this, [this]() {
+        wmTransition("networkForgotten");
+    });
+    QObject::connect(this, &NDBDbus::wmNetworkFailedToConnect, this, [this]() {
+        wmSt.connected = wmSt.trying = false;
+        wmTransition("networkFailedToConnect");
+    });
+    QObject::connect(this, &NDBDbus::wmScanningStarted, this, [this]() {
+        wmSt.scanning = true;
+        wmTransition("scanningStarted");
+    });
+    QObject::connect(this, &NDBDbus::wmScanningFinished, this, [this]() {
+        wmSt.scanning = false;
+        wmTransition("scanningFinished");
+    });
+    QObject::connect(this, &NDBDbus::wmScanningAborted, this, [this]() {
+        wmSt.scanning = false;
+        wmTransition("scanningAborted");
+    });
+    QObject::connect(this, &NDBDbus::wmWifiEnabled, this, [this](bool enabled) {
+        wmSt.enabledKnown = true;
+        wmSt.enabled = enabled;
+        if (!enabled) {
+            wmSt.connected = wmSt.trying = wmSt.scanning = false;
+            wmSt.linkQuality = -1.0;
+        }
+        wmTransition("wifiEnabled");
+    });
+    // Link quality updates are frequent, and aren't a change of state
+    QObject::connect(this, &NDBDbus::wmLinkQualityForConnectedNetwork, this, [this](double quality) {
+        wmSt.linkQuality = quality;
+    });
+    QObject::connect(this, &NDBDbus::wmMacAddressAvailable, this, [this](QString mac) {
+        wmSt.macAddress = mac;
+    });
+}
+
+void NDBDbus::wmTransition(const char *event) {
+    wmSt.lastEvent = QString(event);
+    wmSt.lastChange.start();
+    propChanged("wifiState");
+}
+
+void NDBDbus::ndbWireless(const char *act) {
+    ndbNmAction("ndbWireless", nm_action_nickel_wifi, act);
 }
 
 void NDBDbus::onWWAboutToKillWifi(PermissionRequest* allow) {
@@ -856,6 +2755,9 @@ void NDBDbus::onWWAboutToKillWifi(PermissionRequest* allow) {
  * Set \a keepalive to \c true to enable the keepalive, and \c false to disable it.
  * It is best to only keep Wifi enabled as long as necessary.
  * 
+ * This is a global switch, which stays on even if the caller exits. Prefer
+ * \l ndbWifiKeepaliveAcquire(), which is released automatically.
+ * 
  * \since 0.3.0
  */
 void NDBDbus::ndbWifiKeepalive(bool keepalive) {
@@ -863,12 +2765,141 @@ void NDBDbus::ndbWifiKeepalive(bool keepalive) {
     NDB_DBUS_ASSERT((void) 0, QDBusError::InternalError, nSym.WirelessWatchdog__sharedInstance, "no WirelessWatchdog::sharedInstance() symbol");
     WirelessWatchdog *wd = nSym.WirelessWatchdog__sharedInstance();
     NDB_DBUS_ASSERT((void) 0, QDBusError::InternalError, wd, "could not get WirelessWatchdog::sharedInstance()");
-    if (keepalive) {
+    wifiKeepaliveGlobal = keepalive;
+    wifiKeepaliveUpdate();
+    return;
+}
+
+/*!
+ * \brief Take a lease that keeps the Wifi connection alive
+ * 
+ * Like \l ndbWifiKeepalive(), but Wifi is only kept alive while at least one 
+ * lease is held. The lease is released by \l ndbWifiKeepaliveRelease(), when 
+ * the caller disconnects from D-Bus (including if it crashes), or after 
+ * \a expiry milliseconds if \a expiry is greater than \c 0. An expiring
+ * lease can be extended with \l ndbWifiKeepaliveRenew().
+ * 
+ * Returns the lease, to be passed to \l ndbWifiKeepaliveRenew() and 
+ * \l ndbWifiKeepaliveRelease().
+ * 
+ * \since 0.4.0
+ */
+int NDBDbus::ndbWifiKeepaliveAcquire(int expiry) {
+    NDB_DBUS_USB_ASSERT(0);
+    NDB_DBUS_ASSERT(0, QDBusError::InternalError, nSym.WirelessWatchdog__sharedInstance && nSym.WirelessWatchdog__sharedInstance(), "could not get WirelessWatchdog::sharedInstance()");
+    NDB_DBUS_ASSERT(0, QDBusError::InvalidArgs, expiry >= 0, "expiry must not be negative");
+    int lease = wifiNextLease;
+    wifiNextLease = (wifiNextLease == INT_MAX) ? 1 : wifiNextLease + 1;
+    WifiLease& l = wifiLeases[lease];
+    l.owner = calledFromDBus() ? message().service() : QString();
+    l.deadline = (expiry > 0) ? wifiLeaseClock.elapsed() + expiry : 0;
+    wifiKeepaliveUpdate();
+    return lease;
+}
+
+/*!
+ * \internal
+ * \brief Check whether the caller owns \a lease
+ * 
+ * Calls replayed after a USBMS session come from the replay connection rather
+ * than their original sender, so they are always allowed.
+ */
+bool NDBDbus::wifiLeaseCallerOwns(int lease) {
+    if (!calledFromDBus()) {
+        return true;
+    }
+    QString sender = message().service();
+    if (sender == QDBusConnection(QStringLiteral(NDB_USBMS_REPLAY_CONN)).baseService()) {
+        return true;
+    }
+    return sender == wifiLeases.value(lease).owner;
+}
+
+/*!
+ * \brief Extend a Wifi keepalive lease
+ * 
+ * \a lease will now expire \a expiry milliseconds from now, or never if 
+ * \a expiry is \c 0. Only the client that acquired \a lease may renew it.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::ndbWifiKeepaliveRenew(int lease, int expiry) {
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, wifiLeases.contains(lease), "no such lease %d, it may have expired", lease);
+    NDB_DBUS_ASSERT((void) 0, QDBusError::AccessDenied, wifiLeaseCallerOwns(lease), "lease %d belongs to another client", lease);
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, expiry >= 0, "expiry must not be negative");
+    wifiLeases[lease].deadline = (expiry > 0) ? wifiLeaseClock.elapsed() + expiry : 0;
+    wifiKeepaliveUpdate();
+}
+
+/*!
+ * \brief Release a Wifi keepalive lease
+ * 
+ * Nickel may turn Wifi off once \a lease and every other lease are released.
+ * Only the client that acquired \a lease may release it.
+ * 
+ * \since 0.4.0
+ */
+void NDBDbus::ndbWifiKeepaliveRelease(int lease) {
+    NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, wifiLeases.contains(lease), "no such lease %d, it may have expired", lease);
+    NDB_DBUS_ASSERT((void) 0, QDBusError::AccessDenied, wifiLeaseCallerOwns(lease), "lease %d belongs to another client", lease);
+    wifiLeases.remove(lease);
+    wifiKeepaliveUpdate();
+}
+
+/*!
+ * \internal
+ * \brief Release the leases held by bus name \a name, which has disconnected
+ */
+void NDBDbus::onWifiLeaseOwnerGone(QString const& name) {
+    for (auto it = wifiLeases.begin(); it != wifiLeases.end();) {
+        if (it->owner == name) {
+            nh_log("releasing wifi keepalive lease %d of %s", it.key(), name.toUtf8().constData());
+            it = wifiLeases.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    wifiKeepaliveUpdate();
+}
+
+/*!
+ * \internal
+ * \brief Drop expired leases, and deny the watchdog only while Wifi is wanted
+ */
+void NDBDbus::wifiKeepaliveUpdate() {
+    qint64 now = wifiLeaseClock.elapsed();
+    qint64 next = -1;
+    QStringList owners;
+    for (auto it = wifiLeases.begin(); it != wifiLeases.end();) {
+        if (it->deadline && it->deadline <= now) {
+            nh_log("wifi keepalive lease %d expired", it.key());
+            it = wifiLeases.erase(it);
+            continue;
+        }
+        if (it->deadline && (next < 0 || it->deadline < next)) {
+            next = it->deadline;
+        }
+        if (!it->owner.isEmpty() && !owners.contains(it->owner)) {
+            owners.append(it->owner);
+        }
+        ++it;
+    }
+    if (next >= 0) {
+        wifiLeaseTimer->start(next - now);
+    } else {
+        wifiLeaseTimer->stop();
+    }
+    wifiLeaseWatcher->setWatchedServices(owners);
+
+    WirelessWatchdog *wd = nSym.WirelessWatchdog__sharedInstance ? nSym.WirelessWatchdog__sharedInstance() : nullptr;
+    if (!wd) {
+        return;
+    }
+    if (wifiKeepaliveGlobal || !wifiLeases.isEmpty()) {
         QObject::connect(wd, SIGNAL(aboutToKillWifi(PermissionRequest*)), this, SLOT(onWWAboutToKillWifi(PermissionRequest*)), Qt::UniqueConnection);
     } else {
         QObject::disconnect(wd, SIGNAL(aboutToKillWifi(PermissionRequest*)), this, SLOT(onWWAboutToKillWifi(PermissionRequest*)));
     }
-    return;
 }
 
 /*!
@@ -904,13 +2935,7 @@ void NDBDbus::bwmOpenBrowser(bool modal, QString const& url, QString const& css)
     } else {
         qb_arg = QByteArray();
     }
-    nm_action_result_t *res = nm_action_nickel_browser((qb_arg.isEmpty() ? NULL : qb_arg.constData()));
-    if (!res) {
-        nh_log("bwmOpenBrowser failed with error: %s", nm_err_peek());
-        sendErrorReply(QDBusError::InternalError, QString("bwmOpenBrowser failed with error: %1").arg(nm_err()));
-        return;
-    }
-    nm_action_result_free(res);
+    ndbNmAction("bwmOpenBrowser", nm_action_nickel_browser, (qb_arg.isEmpty() ? NULL : qb_arg.constData()));
 }
 
 /*!
@@ -973,16 +2998,118 @@ void NDBDbus::nsAutoUSBGadget(QString const& action) {
     return ndbSettings(action, "auto_usb_gadget");
 }
 
+/*!
+ * \brief Apply several Nickel settings at once, and report their state
+ * 
+ * Each entry of \a settings is of the form \c {action:setting}, where \c action
+ * is one of \c {enable}, \c {disable} or \c {toggle}, and \c setting is one of
+ * \c {invert}, \c {dark_mode}, \c {lockscreen}, \c {screenshots}, 
+ * \c {force_wifi} or \c {auto_usb_gadget}. Settings are applied in order.
+ * 
+ * Returns one entry per setting of the form \c {setting:previous:new}, where
+ * each value is \c {enabled}, \c {disabled}, or \c {unknown} if it could not
+ * be read on this firmware. A setting that is already in the requested state
+ * is not written again.
+ * 
+ * Every entry is checked before any setting is changed. If applying a setting
+ * fails, an error is returned, and the settings before it remain applied.
+ * 
+ * \since 0.4.0
+ */
+QStringList NDBDbus::nsApply(QStringList const& settings) {
+    static const QStringList validSettings = QStringList() << "invert" << "dark_mode" << "lockscreen" 
+                                                           << "screenshots" << "force_wifi" << "auto_usb_gadget";
+    QStringList results;
+    NDB_DBUS_USB_ASSERT(results);
+    for (QString const& entry : settings) {
+        QStringList parts = entry.split(':');
+        NDB_DBUS_ASSERT(results, QDBusError::InvalidArgs, parts.size() == 2 && ndbActionStrValid(parts.at(0)) && validSettings.contains(parts.at(1)),
+            "invalid setting entry '%s'", entry.toUtf8().constData());
+    }
+    auto state = [](bool known, bool v) {
+        return QString(known ? (v ? "enabled" : "disabled") : "unknown");
+    };
+    for (QString const& entry : settings) {
+        QString action = entry.section(':', 0, 0);
+        QString setting = entry.section(':', 1, 1);
+        bool prev = false, next = false;
+        bool known = ndbReadSetting(setting, &prev);
+        if (known) {
+            bool want = (action == "toggle") ? !prev : (action == "enable");
+            if (want == prev) {
+                results.append(QString("%1:%2:%3").arg(setting).arg(state(true, prev)).arg(state(true, prev)));
+                continue;
+            }
+            // Be explicit, so the result doesn't depend on Nickel's idea of toggling
+            action = want ? "enable" : "disable";
+        }
+        QByteArray qarg = QString("%1:%2").arg(action).arg(setting).toUtf8();
+        QString msg;
+        NDB_DBUS_ASSERT(QStringList(), QDBusError::InternalError, ndbRunNmAction(nm_action_nickel_setting, qarg.constData(), msg), 
+            "nsApply: failed to apply '%s': %s", entry.toUtf8().constData(), msg.toUtf8().constData());
+        bool nextKnown = ndbReadSetting(setting, &next);
+        results.append(QString("%1:%2:%3").arg(setting).arg(state(known, prev)).arg(state(nextKnown, next)));
+    }
+    return results;
+}
+
+/*!
+ * \internal
+ * \brief Read the current value of a Nickel boolean \a setting into \a value
+ * 
+ * This uses the same settings classes as NickelMenu's \c nickel_setting action.
+ * Returns \c false if the setting could not be read.
+ */
+bool NDBDbus::ndbReadSetting(QString const& setting, bool *value) {
+    if (!nSym.Device__getCurrentDevice || !(nSym.Settings__Settings || nSym.Settings__SettingsLegacy) || !nSym.Settings__SettingsD) {
+        return false;
+    }
+    for (auto const& d : ndbSettingDescs) {
+        if (setting != QLatin1String(d.name)) {
+            continue;
+        }
+        void *vtable = dlsym(libnickel, d.vtable);
+        void *baseVtable = dlsym(libnickel, "_ZTV8Settings");
+        bool (*getter)(Settings*) = nullptr;
+        if (d.getter) {
+            reinterpret_cast<void*&>(getter) = dlsym(libnickel, d.getter);
+        }
+        if (!vtable || !baseVtable || (d.getter ? !getter : !nSym.Settings__getSetting)) {
+            NDB_DEBUG("could not resolve symbols to read setting %s", d.name);
+            return false;
+        }
+        Device *dev = nSym.Device__getCurrentDevice();
+        if (!dev) {
+            return false;
+        }
+        // Settings is much smaller than this, but it's better to be safe
+        alignas(void*) char settings[256] = {0};
+        if (nSym.Settings__Settings) {
+            nSym.Settings__Settings(settings, dev, false);
+        } else {
+            nSym.Settings__SettingsLegacy(settings, dev);
+        }
+        // Turn the generic Settings into the subclass the setting belongs to by
+        // pointing it at the subclass vtable (skipping the offset-to-top and 
+        // typeinfo entries), as NickelMenu does.
+        *reinterpret_cast<void**>(settings) = reinterpret_cast<char*>(vtable) + 2 * sizeof(void*);
+        if (getter) {
+            *value = getter(settings);
+        } else {
+            *value = nSym.Settings__getSetting(settings, QString(d.key), QVariant(false)).toBool();
+        }
+        // Restore the base class vtable before destroying it as a Settings
+        *reinterpret_cast<void**>(settings) = reinterpret_cast<char*>(baseVtable) + 2 * sizeof(void*);
+        nSym.Settings__SettingsD(settings);
+        return true;
+    }
+    return false;
+}
+
 void NDBDbus::ndbSettings(QString const& action, const char* setting) {
     NDB_DBUS_ASSERT((void) 0, QDBusError::InvalidArgs, ndbActionStrValid(action), "invalid action name");
     QByteArray qarg = QString("%1:%2").arg(action).arg(setting).toUtf8();
-    nm_action_result_t *res = nm_action_nickel_setting(qarg.constData());
-    if (!res) {
-        nh_log("ndbSettings failed with error: %s", nm_err());
-        sendErrorReply(QDBusError::InternalError, QString("ndbSettings failed with error: %1").arg(nm_err()));
-        return;
-    }
-    nm_action_result_free(res);
+    ndbNmAction("ndbSettings", nm_action_nickel_setting, qarg.constData());
 }
 
 /*!
@@ -1012,13 +3139,7 @@ void NDBDbus::pwrSleep() {
 }
 
 void NDBDbus::pwrAction(const char *action) {
-    nm_action_result_t *res = nm_action_power(action);
-    if (!res) {
-        nh_log("pwrAction failed with error: %s", nm_err_peek());
-        sendErrorReply(QDBusError::InternalError, QString("pwrAction failed with error: %1").arg(nm_err()));
-        return;
-    }
-    nm_action_result_free(res);
+    ndbNmAction("pwrAction", nm_action_power, action);
 }
 
 void NDBDbus::rvConnectSignals(QWidget* rv) {
@@ -1094,6 +3215,35 @@ QString NDBDbus::imgSizeForType(QString const& type) {
  * \since 0.2.0
  */
 
+/*!
+ * \fn void NDB::NDBDbus::dlgResult(int handle, int result)
+ * \brief The signal that is emitted when the dialog identified by \a handle is dismissed
+ * 
+ * When emitted, \a result will be \c 1 for ACCEPT or \c 0 for REJECT
+ * 
+ * \since 0.4.0
+ */
+
+/*!
+ * \fn void NDB::NDBDbus::dlgTextInput(int handle, QString input)
+ * \brief The signal that is emitted when the line edit dialog identified by \a handle is dismissed
+ * 
+ * When emitted \a input will be the text the user inputted if the dialog was
+ * accepted, or an empty string otherwise. It is emitted before \l dlgResult().
+ * 
+ * \since 0.4.0
+ */
+
+/*!
+ * \fn void NDB::NDBDbus::ndbUsbmsStateChanged(bool active)
+ * \brief The signal that is emitted when a USB mass storage session starts or ends
+ * 
+ * \a active is \c true when a session has started, and \c false once it has
+ * ended and methods can be called again.
+ * 
+ * \since 0.4.0
+ */
+
 /*!
  * \fn void NDB::NDBDbus::pfmDoneProcessing()
  * \brief The signal that nickel emits when the content import process has completed.
@@ -1176,19 +3326,75 @@ QString NDBDbus::imgSizeForType(QString const& type) {
  * \fn void NDB::NDBDbus::ndbViewChanged(QString newView)
  * \brief The signal that is emitted when the current view changes
  * 
- * This signal is only emitted if \l NDB::NDBDbus::ndbCurrentView() has been called 
- * at least once by an application. \a newView is the class name of the new view.
+ * View changes are tracked from shortly after Nickel has started. \a newView 
+ * is the class name of the new view.
  * 
  * \sa NDB::NDBDbus::ndbCurrentView()
  */
 
+/*!
+ * \property NDB::NDBDbus::version
+ * \brief The version of NickelDBus
+ * 
+ * \sa ndbVersion()
+ * \since 0.4.0
+ */
+
+/*!
+ * \property NDB::NDBDbus::firmwareVersion
+ * \brief The current firmware version
+ * 
+ * Empty if it could not be determined, which may happen during a USB mass 
+ * storage session.
+ * 
+ * \sa ndbFirmwareVersion()
+ * \since 0.4.0
+ */
+
+/*!
+ * \property NDB::NDBDbus::currentView
+ * \brief The class name of the current view
+ * 
+ * As with \l ndbViewChanged(), changes are only announced after the current
+ * view has been read at least once.
+ * 
+ * \sa ndbCurrentView()
+ * \since 0.4.0
+ */
+
+/*!
+ * \property NDB::NDBDbus::usbmsActive
+ * \brief Whether a USB mass storage session is active
+ * 
+ * \sa ndbUsbmsActive()
+ * \since 0.4.0
+ */
+
+/*!
+ * \property NDB::NDBDbus::wifiState
+ * \brief The state of the Wifi connection
+ * 
+ * One of \c unknown (no wireless events seen yet), \c disabled, \c enabled, 
+ * \c connecting or \c connected.
+ * 
+ * \sa wmState()
+ * \since 0.4.0
+ */
+
+/*!
+ * \property NDB::NDBDbus::connectedSignals
+ * \brief The names of the Nickel signals NickelDBus is connected to
+ * 
+ * \sa ndbSignalConnected()
+ * \since 0.4.0
+ */
+
 /*!
  * \fn void NDB::NDBDbus::rvPageChanged(int pageNum)
  * \brief The signal that is emitted when the current book changes page
  * 
- * This signal is only emitted if \l NDB::NDBDbus::ndbCurrentView() has been called 
- * at least once by an application. \a pageNum is kepub or epub page 
- * number of the new page.
+ * This signal is emitted once the reading view has been shown. \a pageNum is 
+ * kepub or epub page number of the new page.
  * 
  * \sa NDB::NDBDbus::ndbCurrentView()
  */
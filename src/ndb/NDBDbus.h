@@ -4,13 +4,18 @@
 #include <QObject>
 #include <QString>
 #include <QSet>
+#include <QVector>
 #include <QStackedWidget>
 #include <QtDBus>
 #include <QDBusContext>
 #include <QLabel>
 #include <QSize>
 #include <QTimer>
+#include <QElapsedTimer>
+#include "../../NickelMenu/src/action.h"
 #include "NDBCfmDlg.h"
+#include "NDBFlightRecorder.h"
+#include "ndb_state.h"
 
 typedef void PlugManager;
 typedef QObject PlugWorkflowManager;
@@ -23,6 +28,7 @@ typedef QObject FSSyncManager;
 typedef FSSyncManager N3FSSyncManager;
 typedef bool PermissionRequest;
 typedef QObject WirelessWatchdog;
+typedef void Settings;
 
 #ifndef NDB_DBUS_IFACE_NAME
     #define NDB_DBUS_IFACE_NAME "com.github.shermp.nickeldbus"
@@ -30,12 +36,34 @@ typedef QObject WirelessWatchdog;
 #ifndef NDB_DBUS_OBJECT_PATH
     #define NDB_DBUS_OBJECT_PATH "/nickeldbus"
 #endif
+#ifndef NDB_FLIGHT_PATH
+    #define NDB_FLIGHT_PATH "/tmp/nickeldbus-flight"
+#endif
+#ifndef NDB_FLIGHT_SIZE
+    #define NDB_FLIGHT_SIZE (256 * 1024)
+#endif
+#ifndef NDB_DBUS_PEER_ADDRESS
+    #define NDB_DBUS_PEER_ADDRESS "unix:path=/tmp/nickeldbus-peer"
+#endif
 
 namespace NDB {
 
+// A D-Bus method call that will be replied to at a later time
+struct NDBDelayedReply {
+    QDBusConnection conn = QDBusConnection(QString());
+    QDBusMessage msg;
+};
+
 class NDBDbus : public QObject, protected QDBusContext {
     Q_OBJECT
+    friend class NDBFlightAdapter;
     Q_CLASSINFO("D-Bus Interface", NDB_DBUS_IFACE_NAME)
+    Q_PROPERTY(QString version READ ndbVersion)
+    Q_PROPERTY(QString firmwareVersion READ ndbFirmwareVersion)
+    Q_PROPERTY(QString currentView READ ndbCurrentView)
+    Q_PROPERTY(bool usbmsActive READ ndbUsbmsActive)
+    Q_PROPERTY(QString wifiState READ propWifiState)
+    Q_PROPERTY(QStringList connectedSignals READ propConnectedSignals)
 
     QDBusConnection conn = QDBusConnection::systemBus();
     
@@ -49,6 +77,8 @@ class NDBDbus : public QObject, protected QDBusContext {
     Q_SIGNALS:
         void dlgConfirmResult(int result);
         void dlgConfirmTextInput(QString input);
+        void dlgResult(int handle, int result);
+        void dlgTextInput(int handle, QString input);
         // PlugworkFlowManager signals
         void pfmDoneProcessing();
         void pfmAboutToConnect();
@@ -70,6 +100,7 @@ class NDBDbus : public QObject, protected QDBusContext {
         void wmMacAddressAvailable(QString mac);
         void ndbViewChanged(QString newView);
         void rvPageChanged(int pageNum);
+        void ndbUsbmsStateChanged(bool active);
 
     public Q_SLOTS:
         QString ndbVersion();
@@ -79,7 +110,14 @@ class NDBDbus : public QObject, protected QDBusContext {
         QString ndbFirmwareVersion();
         // misc
         bool ndbSignalConnected(QString const& signalName);
+        bool ndbUsbmsActive();
+        void ndbUsbmsDefer(bool defer, int expiry);
+        QString ndbPeerListen(bool listen);
+        QVariantMap ndbCapabilities();
+        QVariantList ndbEventsSince(qulonglong seq, int max, qulonglong& latest);
+        QVariantMap ndbWaitFor(QString const& signalName, QString const& predicate, int timeout);
         void mwcToast(int toastDuration, QString const& msgMain, QString const& msgSub = QStringLiteral(""));
+        void mwcToastReplace(QString const& key, int toastDuration, QString const& msgMain, QString const& msgSub = QStringLiteral(""));
         void mwcHome();
         // Confirmation Dialogs
         void dlgConfirmNoBtn(QString const& title, QString const& body);
@@ -97,8 +135,28 @@ class NDBDbus : public QObject, protected QDBusContext {
         void dlgConfirmSetProgress(int min, int max, int val, QString const& format = "");
         void dlgConfirmSetLEPassword(bool password);
         void dlgConfirmSetLEPlaceholder(QString const& placeholder);
+        QDBusUnixFileDescriptor dlgConfirmProgressPipe(bool closeOnEof);
         void dlgConfirmShow();
         void dlgConfirmClose();
+        QString dlgConfirmForm(QString const& form);
+        // Dialogs addressed by handle
+        int dlgCreate(bool createLineEdit = false, int priority = 0);
+        void dlgSetTitle(int handle, QString const& title);
+        void dlgSetBody(int handle, QString const& body);
+        void dlgSetAccept(int handle, QString const& acceptText);
+        void dlgSetReject(int handle, QString const& rejectText);
+        void dlgSetModal(int handle, bool modal);
+        void dlgShowClose(int handle, bool show);
+        void dlgSetProgress(int handle, int min, int max, int val, QString const& format = "");
+        void dlgSetLEPassword(int handle, bool password);
+        void dlgSetLEPlaceholder(int handle, QString const& placeholder);
+        QDBusUnixFileDescriptor dlgProgressPipe(int handle, bool closeOnEof);
+        void dlgShow(int handle);
+        void dlgClose(int handle);
+        // Dialogs that reply with the user's answer
+        int dlgPromptConfirm(QString const& title, QString const& body, QString const& acceptText, QString const& rejectText, int timeout);
+        int dlgPromptText(QString const& title, QString const& placeholder, int timeout, QString& text);
+        int dlgPromptPassword(QString const& title, QString const& placeholder, int timeout, QString& text);
         // PlugWorkFlowManager
         void pfmRescanBooks();
         void pfmRescanBooksFull();
@@ -110,8 +168,12 @@ class NDBDbus : public QObject, protected QDBusContext {
         void wfmConnectWireless();
         void wfmConnectWirelessSilently();
         void wfmSetAirplaneMode(QString const& action);
+        QVariantMap wmState();
         // Wireless watchdog
         void ndbWifiKeepalive(bool keepalive);
+        int ndbWifiKeepaliveAcquire(int expiry);
+        void ndbWifiKeepaliveRenew(int lease, int expiry);
+        void ndbWifiKeepaliveRelease(int lease);
         // Web Browser (BrowserWorkflowManager)
         void bwmOpenBrowser(bool modal = false, QString const& url = QString(), QString const& css = QString());
         // Nickel Settings
@@ -121,6 +183,10 @@ class NDBDbus : public QObject, protected QDBusContext {
         void nsScreenshots(QString const& action);
         void nsForceWifi(QString const& action);
         void nsAutoUSBGadget(QString const& action);
+        QStringList nsApply(QStringList const& settings);
+        // NickelMenu actions
+        QString nmAction(QString const& type, QString const& arg);
+        QStringList nmChain(QStringList const& actions, bool stopOnError);
         // Power commands
         void pwrShutdown();
         void pwrReboot();
@@ -130,16 +196,89 @@ class NDBDbus : public QObject, protected QDBusContext {
     protected Q_SLOTS:
         void handleQSWCurrentChanged(int index);
         void handleQSWTimer();
+        void viewTrackStart();
         void handleStackedWidgetDestroyed();
         void onDlgLineEditAccepted();
         void onDlgLineEditRejected();
+        void dlgShowNext();
+        void toastShowNext();
         void onWWAboutToKillWifi(PermissionRequest* allow);
+        void onWifiLeaseOwnerGone(QString const& name);
+        void wifiKeepaliveUpdate();
+        void usbmsPoll();
+        void usbmsReplayDeferred();
+        void usbmsExpireDeferred();
+        void onUsbmsDeferClientGone(QString const& name);
+        void onDlgOwnerGone(QString const& name);
+        void propEmitChanged();
+        void onPeerConnection(QDBusConnection const& peer);
+        void waitExpire();
+        void onWaiterGone(QString const& name);
     private:
         void *libnickel;
+        QMap<QString, bool> nickelSymbols; // Mangled name to whether it resolved
+        NDBFlightRecorder flight;
+        struct ndb_state_page *statePage = nullptr;
+        QString stateView;
+        int stateBookPage = -1;
+        void stateOpen();
+        void stateUpdate();
+        enum ndb_wifi_state wifiState();
+        void flightRecordCall(const char *method);
+        // Ring buffer of recently emitted signals, for clients that missed them
+        struct JournalEvent {
+            qulonglong seq = 0;
+            qint64 time = 0; // ms since the epoch
+            QString name;
+            QVariantList args;
+        };
+        QVector<JournalEvent> journal;
+        qulonglong journalSeq = 0; // Sequence number of the newest event
+        void journalTrackSignals();
+        template <typename... Args>
+        void journalSignal(void (NDBDbus::*sig)(Args...), const char *name);
+        void journalAppend(const char *name, QVariantList const& args);
+        // Callers of ndbWaitFor() waiting for a signal
+        struct Waiter {
+            QString signalName;
+            QString predicate;
+            qint64 deadline; // On waitClock, 0 to wait forever
+            QString owner;   // Bus name of the caller
+            NDBDelayedReply reply;
+        };
+        QList<Waiter> waiters;
+        QElapsedTimer waitClock;
+        QTimer *waitTimer;
+        QDBusServiceWatcher *waitWatcher;
+        void waitUnwatch(QString const& owner);
+        bool waitStateHolds(QString const& signalName, QString const& predicate);
+        void waitNotify(QString const& name, QVariantList const& args);
+        // Properties changed since PropertiesChanged was last emitted
+        QSet<QString> propDirty;
+        QVariantMap propSent;
+        QTimer *propTimer;
+        void propChanged(QString const& name);
+        QString propWifiState();
+        QStringList propConnectedSignals();
+        // Direct connections from clients, bypassing the bus daemon
+        QDBusServer *peerServer = nullptr;
+        QList<QDBusConnection> peerConns;
+        void ndbSendSignal(QDBusMessage const& sig);
         QSet<QString> connectedSignals;
         QStackedWidget *stackedWidget = nullptr;
         QString fwVersion;
         NDBCfmDlg *cfmDlg;
+        struct DlgHandle {
+            NDBCfmDlg *dlg = nullptr;
+            int priority = 0;
+            QString owner; // Bus name of the client that created the dialog
+            NDBDelayedReply reply;
+        };
+        QMap<int, DlgHandle> dlgHandles;
+        QList<int> dlgQueue;
+        int dlgNextHandle = 1;
+        int dlgActiveHandle = 0;
+        QDBusServiceWatcher *dlgOwnerWatcher;
         //NDBN3Dlg *n3Dlg;
         struct {
             bool *(*PlugManager__gadgetMode)(PlugManager*);
@@ -156,18 +295,93 @@ class NDBDbus : public QObject, protected QDBusContext {
             N3FSSyncManager* (*N3FSSyncManager__sharedInstance)();
             void (*N3FSSyncManager__sync)(N3FSSyncManager* _this, QStringList* paths);
             WirelessWatchdog* (*WirelessWatchdog__sharedInstance)();
+            void *(*Settings__Settings)(Settings*, Device*, bool);
+            void *(*Settings__SettingsLegacy)(Settings*, Device*);
+            void *(*Settings__SettingsD)(Settings*);
+            QVariant (*Settings__getSetting)(Settings*, QString const&, QVariant const&);
         } nSym;
         QTimer *viewTimer;
+        QTimer *viewTrackTimer;
+        QString viewCurrent();
+        // USB mass storage state, tracked from PlugWorkflowManager signals
+        bool usbmsTracked = false;
+        bool usbmsActive = false;
+        bool usbmsSawGadget = false;
+        QElapsedTimer usbmsSince;
+        QTimer *usbmsPollTimer;
+        bool ndbGadgetMode();
+        void usbmsUpdate(bool active);
+        // Calls held back until the current USBMS session ends
+        struct DeferredCall {
+            NDBDelayedReply reply;
+            qint64 deadline;
+        };
+        QMap<QString, int> usbmsDeferClients; // Bus name to expiry
+        QList<DeferredCall> usbmsDeferred;
+        QElapsedTimer usbmsDeferClock;
+        QTimer *usbmsDeferTimer;
+        QDBusServiceWatcher *usbmsDeferWatcher;
+        bool ndbUsbmsDeferCall();
+        struct WifiLease {
+            QString owner;
+            qint64 deadline = 0; // On wifiLeaseClock, 0 if the lease doesn't expire
+        };
+        QMap<int, WifiLease> wifiLeases;
+        int wifiNextLease = 1;
+        bool wifiKeepaliveGlobal = false;
+        QElapsedTimer wifiLeaseClock;
+        QTimer *wifiLeaseTimer;
+        QDBusServiceWatcher *wifiLeaseWatcher;
+        // Wireless state, as last reported by WirelessManager signals
+        struct {
+            bool enabledKnown = false;
+            bool enabled = false;
+            bool connected = false;
+            bool trying = false;
+            bool scanning = false;
+            double linkQuality = -1.0;
+            QString macAddress;
+            QString lastEvent;
+            QElapsedTimer lastChange;
+            QElapsedTimer connectedSince;
+        } wmSt;
+        void wmTrackState();
+        void wmTransition(const char *event);
+        struct Toast {
+            QString key;
+            QString msgMain;
+            QString msgSub;
+            int duration = 0;
+        };
+        QList<Toast> toastQueue;
+        Toast toastCurrent;
+        QTimer *toastTimer;
+        QElapsedTimer toastShown;
+        void toastEnqueue(Toast const& t);
         bool ndbInUSBMS();
+        bool ndbDelayReply(NDBDelayedReply& reply);
+        void ndbSendDelayedReply(NDBDelayedReply& reply, QList<QVariant> const& args);
+        void ndbSendDelayedError(NDBDelayedReply& reply, QDBusError::ErrorType type, QString const& msg);
         bool ndbActionStrValid(QString const& actStr);
+        bool ndbNmActionAllowed(nm_action_fn_t fn);
+        bool wifiLeaseCallerOwns(int lease);
+        bool ndbRunNmAction(nm_action_fn_t fn, const char *arg, QString& msg, int *skip = nullptr);
+        void ndbNmAction(const char *name, nm_action_fn_t fn, const char *arg);
         void ndbWireless(const char *act);
         void ndbSettings(QString const& action, const char* setting);
+        bool ndbReadSetting(QString const& setting, bool *value);
         void ndbNickelMisc(const char *action);
         QString getNickelMetaObjectDetails(const QMetaObject* nmo);
         template <typename T>
         void ndbConnectSignal(T *srcObj, const char *srcSignal, const char *dest);
         void pwrAction(const char *action);
         void rvConnectSignals(QWidget* rv);
+        int dlgAddHandle(NDBCfmDlg *d, int priority);
+        void dlgEnqueue(int handle);
+        void dlgStartDelayed(NDBCfmDlg *d, enum Result res, int priority, int timeout);
+        void dlgTimedOut(int handle);
+        int dlgPromptLineEdit(QString const& title, QString const& placeholder, bool password, int timeout);
+        void dlgHandleFinished(int handle, int result);
         void dlgConfirmLineEditFull(QString const& title, QString const& acceptText, QString const& rejectText, bool isPassword, QString const& setText);
         enum Result dlgConfirmCreatePreset(QString const& title, QString const& body, QString const& acceptText, QString const& rejectText);
         void n3fssSync(QStringList* paths);
@@ -0,0 +1,173 @@
+#include <atomic>
+#include <cstddef>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <QDateTime>
+#include <NickelHook.h>
+#include "NDBFlightRecorder.h"
+
+namespace NDB {
+
+static const char flightMagic[8] = {'N', 'D', 'B', 'F', 'L', 'T', '\0', '\0'};
+static const quint32 flightVersion = 1;
+
+NDBFlightRecorder::NDBFlightRecorder() {}
+
+NDBFlightRecorder::~NDBFlightRecorder() {
+    if (hdr) {
+        munmap(hdr, mapLen);
+    }
+}
+
+/*!
+ * \internal
+ * \brief Map the ring file at \a path, holding \a capacity bytes of records
+ *
+ * Records already in the file are kept, so the file covers several runs of
+ * Nickel. It is recreated if it has a different format or size. Returns
+ * \c false if the file could not be mapped, in which case nothing is recorded.
+ */
+bool NDBFlightRecorder::open(const char *path, quint32 capacity) {
+    // The decoder relies on this layout
+    static_assert(sizeof(Header) == 64 && sizeof(RecordHeader) == 24, "unexpected flight recorder layout");
+    capacity &= ~3u;
+    int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0644);
+    if (fd < 0) {
+        nh_log("could not open flight recorder %s: %m", path);
+        return false;
+    }
+    mapLen = sizeof(Header) + capacity;
+    if (ftruncate(fd, mapLen) != 0) {
+        nh_log("could not resize flight recorder %s: %m", path);
+        close(fd);
+        return false;
+    }
+    void *map = mmap(nullptr, mapLen, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        nh_log("could not map flight recorder %s: %m", path);
+        return false;
+    }
+    hdr = static_cast<Header*>(map);
+    data = static_cast<unsigned char*>(map) + sizeof(Header);
+    if (memcmp(hdr->magic, flightMagic, sizeof(flightMagic)) || hdr->version != flightVersion ||
+        hdr->capacity != capacity || hdr->head < hdr->tail || hdr->head - hdr->tail > capacity) {
+        memset(hdr, 0, sizeof(Header));
+        memcpy(hdr->magic, flightMagic, sizeof(flightMagic));
+        hdr->version = flightVersion;
+        hdr->capacity = capacity;
+    }
+    return true;
+}
+
+/*!
+ * \internal
+ * \brief The time for records written now, reading the clock once per iteration
+ */
+qint64 NDBFlightRecorder::now() {
+    if (clockStale) {
+        clock = QDateTime::currentMSecsSinceEpoch();
+        clockStale = false;
+    }
+    return clock;
+}
+
+/*!
+ * \internal
+ * \brief Start a new event loop iteration, ending the one that ran the last call
+ */
+void NDBFlightRecorder::awake() {
+    clockStale = true;
+    if (callPending) {
+        finishCall();
+    }
+}
+
+/*!
+ * \internal
+ * \brief Note the start of a method call, to be recorded once it returns
+ */
+void NDBFlightRecorder::callStarted() {
+    if (callPending) {
+        // Several calls in one iteration, the previous one ends here
+        clockStale = true;
+        finishCall();
+    }
+    callStart = now();
+}
+
+/*!
+ * \internal
+ * \brief Fill in the duration of the last Call record, unless it has been overwritten
+ */
+void NDBFlightRecorder::finishCall() {
+    callPending = false;
+    if (!hdr || callAt < hdr->tail) {
+        return;
+    }
+    quint32 duration = qMax<qint64>(0, now() - callStart);
+    memcpy(data + callAt % hdr->capacity + offsetof(RecordHeader, duration), &duration, sizeof(duration));
+}
+
+/*!
+ * \internal
+ * \brief Drop the oldest records until \a size more bytes fit
+ */
+void NDBFlightRecorder::reserve(quint32 size) {
+    while (hdr->head + size - hdr->tail > hdr->capacity) {
+        quint16 oldest;
+        memcpy(&oldest, data + hdr->tail % hdr->capacity, sizeof(oldest));
+        if (oldest == 0 || oldest % 4) {
+            // Corrupt, start over
+            hdr->tail = hdr->head;
+            return;
+        }
+        hdr->tail += oldest;
+    }
+}
+
+/*!
+ * \internal
+ * \brief Append a record of \a type
+ *
+ * The meaning of \a a, \a b, \a duration and \a flags depends on \a type. The
+ * strings are truncated to 255 bytes.
+ */
+void NDBFlightRecorder::record(RecordType type, QByteArray const& a, QByteArray const& b, quint32 duration, quint8 flags) {
+    if (!hdr) {
+        return;
+    }
+    RecordHeader r = {};
+    r.lenA = qMin(a.size(), 255);
+    r.lenB = qMin(b.size(), 255);
+    r.size = (sizeof(RecordHeader) + r.lenA + r.lenB + 3) & ~3u;
+    quint32 pos = hdr->head % hdr->capacity;
+    if (pos + r.size > hdr->capacity) {
+        quint16 pad = hdr->capacity - pos;
+        reserve(pad);
+        memcpy(data + pos, &pad, sizeof(pad));
+        data[pos + sizeof(pad)] = Pad;
+        hdr->head += pad;
+        pos = 0;
+    }
+    reserve(r.size);
+    r.type = type;
+    r.flags = flags;
+    r.seq = ++hdr->seq;
+    r.time = now();
+    r.duration = duration;
+    if (type == Call) {
+        callPending = true;
+        callAt = hdr->head;
+    }
+    memcpy(data + pos, &r, sizeof(r));
+    memcpy(data + pos + sizeof(r), a.constData(), r.lenA);
+    memcpy(data + pos + sizeof(r) + r.lenA, b.constData(), r.lenB);
+    // Only publish the record once it is complete
+    std::atomic_signal_fence(std::memory_order_release);
+    hdr->head += r.size;
+}
+
+} // namespace NDB
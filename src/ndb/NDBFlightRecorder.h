@@ -0,0 +1,85 @@
+#ifndef NDB_FLIGHT_RECORDER_H
+#define NDB_FLIGHT_RECORDER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+namespace NDB {
+
+/*
+ * A fixed size ring of binary records in a memory mapped file, so that what
+ * NickelDBus was doing can still be found out after Nickel has crashed or
+ * syslog has rotated. Appending a record only writes to memory.
+ *
+ * The file starts with a Header, followed by `capacity` bytes of records.
+ * Every record starts with a RecordHeader, followed by two strings of
+ * lenA and lenB bytes, padded to a multiple of four bytes. Records are
+ * written at head % capacity. A record that doesn't fit before the end of
+ * the file is preceded by a Pad record filling the rest of it. Records from
+ * tail to head are complete, older ones have been overwritten. All fields are
+ * little endian. script/ndb-flightlog.py decodes the file.
+ *
+ * Reading the clock is a system call on the kernels Kobo devices run, so it
+ * is read at most once per event loop iteration, and every record written in
+ * that iteration shares the timestamp. A Call record gets its duration once
+ * the iteration that ran it is over.
+ */
+class NDBFlightRecorder {
+    public:
+        enum RecordType : quint8 {
+            Pad = 0,    // Filler up to the end of the ring
+            Start = 1,  // NickelDBus started. A: version
+            Call = 2,   // Method call. A: method, B: caller, duration in ms (0 while running)
+            Error = 3,  // Error returned. A: method, B: message
+            Signal = 4, // Signal emitted. A: signal, B: arguments
+            View = 5,   // Current view changed. A: view
+            Usbms = 6,  // USBMS session started (flags 1) or ended (flags 0)
+        };
+        // Record flags for Call
+        enum { DelayedReply = 1 };
+
+        NDBFlightRecorder();
+        ~NDBFlightRecorder();
+        bool open(const char *path, quint32 capacity);
+        void record(RecordType type, QByteArray const& a, QByteArray const& b = QByteArray(), quint32 duration = 0, quint8 flags = 0);
+        // To be called whenever the event loop wakes up
+        void awake();
+        // To be called before the method of the next Call record runs
+        void callStarted();
+    private:
+        struct Header {
+            char magic[8];
+            quint32 version;
+            quint32 capacity;
+            quint64 head;      // Total bytes ever written
+            quint64 tail;      // Total bytes ever overwritten
+            quint32 seq;       // Sequence number of the last record
+            quint8 reserved[28];
+        };
+        struct RecordHeader {
+            quint16 size;      // Including this header, the strings and padding
+            quint8 type;
+            quint8 flags;
+            quint32 seq;
+            qint64 time;       // ms since the epoch
+            quint32 duration;
+            quint8 lenA;
+            quint8 lenB;
+            quint16 reserved;
+        };
+        Header *hdr = nullptr;
+        unsigned char *data = nullptr;
+        size_t mapLen = 0;
+        qint64 clock = 0;          // ms since the epoch, as of this iteration
+        bool clockStale = true;
+        qint64 callStart = 0;
+        bool callPending = false;  // The last Call record still needs its duration
+        quint64 callAt = 0;        // Where that record was written, as for head
+        qint64 now();
+        void finishCall();
+        void reserve(quint32 size);
+};
+
+} // namespace NDB
+
+#endif // NDB_FLIGHT_RECORDER_H
@@ -3,6 +3,20 @@
 
 namespace NDB {
 
+// Built once rather than per progress bar. Qt still parses it again for every
+// setStyleSheet() call.
+static const QString progStyleSheet = QString(R"(
+    QProgressBar:horizontal {
+        border: 1px solid gray;
+        background: white;
+        padding: 1px;
+    }
+    QProgressBar::chunk:horizontal {
+        background-color: black;
+        margin: 0;
+    }
+)");
+
 /*!
  * \brief Create a progress bar
  */
@@ -14,17 +28,7 @@ NDBProgressBar::NDBProgressBar(QWidget *parent, Qt::WindowFlags f)
     label = new QLabel(this);
     layout->addWidget(prog);
     layout->addWidget(label);
-    prog->setStyleSheet(QString(R"(
-        QProgressBar:horizontal {
-            border: 1px solid gray;
-            background: white;
-            padding: 1px;
-        }
-        QProgressBar::chunk:horizontal {
-            background-color: black;
-            margin: 0;
-        }
-    )"));
+    prog->setStyleSheet(progStyleSheet);
     this->setLayout(layout);
     connect(prog, &QProgressBar::valueChanged, this, &NDBProgressBar::setLabel);
 }
@@ -0,0 +1,67 @@
+#ifndef NDB_STATE_H
+#define NDB_STATE_H
+
+/*
+ * The state page NickelDBus publishes at NDB_STATE_PATH, for clients that
+ * need to check its state often. Map the file read-only, and read it with
+ * ndb_state_read(), which needs no system calls and never wakes Nickel.
+ *
+ * This header is plain C, so that clients can include it as is.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define NDB_STATE_PATH "/tmp/nickeldbus-state"
+#define NDB_STATE_MAGIC 0x5453444e /* "NDST" */
+#define NDB_STATE_VERSION 1
+
+enum ndb_wifi_state {
+    NDB_WIFI_UNKNOWN = 0,
+    NDB_WIFI_DISABLED = 1,
+    NDB_WIFI_ENABLED = 2,
+    NDB_WIFI_CONNECTING = 3,
+    NDB_WIFI_CONNECTED = 4,
+};
+
+struct ndb_state_page {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seq;       /* seqlock, odd while the page is being updated */
+    uint32_t size;      /* sizeof(struct ndb_state_page) */
+    uint64_t event_seq; /* sequence number of the last signal, see ndbEventsSince */
+    int64_t updated;    /* when the page was last updated, in ms since the epoch */
+    int32_t page;       /* current page of the open book, -1 if unknown (1) */
+    uint8_t usbms;      /* 1 during a USB mass storage session */
+    uint8_t wifi;       /* enum ndb_wifi_state */
+    uint8_t reserved[2];
+    char view[64];      /* class name of the current view, NUL terminated (1) */
+};
+/* (1) Empty until Nickel's main window exists, shortly after Nickel starts */
+
+/* Number of times ndb_state_read() tries for a consistent copy */
+#define NDB_STATE_READ_TRIES 1000
+
+/*
+ * Take a consistent copy of the state page at p into out. Returns 0, or -1 if
+ * p isn't a state page this header understands, or no consistent copy could
+ * be taken (such as when Nickel crashed in the middle of an update).
+ */
+static inline int ndb_state_read(const struct ndb_state_page *p, struct ndb_state_page *out) {
+    uint32_t s1, s2;
+    if (p->magic != NDB_STATE_MAGIC || p->version != NDB_STATE_VERSION) {
+        return -1;
+    }
+    for (int i = 0; i < NDB_STATE_READ_TRIES; i++) {
+        s1 = __atomic_load_n(&p->seq, __ATOMIC_ACQUIRE);
+        memcpy(out, p, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&p->seq, __ATOMIC_RELAXED);
+        if (!(s1 & 1) && s1 == s2) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+#endif /* NDB_STATE_H */
@@ -4,16 +4,20 @@
 
 namespace NDB {
 
-void resolveSymbol(void* libnickel, const char *name, void **fn) {
+bool resolveSymbol(void* libnickel, const char *name, void **fn) {
     if (!(*fn = dlsym(libnickel, name))) {
         nh_log("info... could not load %s", name);
+        return false;
     }
+    return true;
 }
 
-void resolveSymbolRTLD(const char *name, void **fn) {
+bool resolveSymbolRTLD(const char *name, void **fn) {
     if (!(*fn = dlsym(RTLD_DEFAULT, name))) {
         nh_log("info... could not load %s", name);
+        return false;
     }
+    return true;
 }
 
 } // namespace
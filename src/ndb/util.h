@@ -18,19 +18,28 @@ namespace NDB {
 // Note: make sure you are including <QtDBus> and <QDBusContext> for this to work!
 #define NDB_DBUS_ASSERT(ret, dbus_err, cond, fmt, ...) if (!(cond)) { \
     nh_log(fmt, ##__VA_ARGS__);                                       \
+    QString qstr;                                                     \
+    qstr.sprintf(fmt, ##__VA_ARGS__);                                 \
+    flight.record(NDBFlightRecorder::Error, __func__, qstr.toUtf8()); \
     if (calledFromDBus()) {                                           \
-        QString qstr;                                                 \
-        sendErrorReply((dbus_err), qstr.sprintf(fmt, ##__VA_ARGS__)); \
+        sendErrorReply((dbus_err), qstr);                             \
     }                                                                 \
     return (ret);                                                     \
 }
 
-// Shorthand for the common USBMS assertion
-#define NDB_DBUS_USB_ASSERT(ret) NDB_DBUS_ASSERT(ret, QDBusError::InternalError, !ndbInUSBMS(), "not calling method %s: in usbms session", __func__)
+// Shorthand for the common USBMS assertion. Calls from clients that opted in
+// with ndbUsbmsDefer() are queued until the session ends instead.
+#define NDB_DBUS_USB_ASSERT(ret) if (ndbInUSBMS() && ndbUsbmsDeferCall()) { return (ret); } \
+    NDB_DBUS_ASSERT(ret, QDBusError::InternalError, !ndbInUSBMS(), "not calling method %s: in usbms session", __func__)
 // Shorthand for the common nickel symbol resolve assertion
 #define NDB_DBUS_SYM_ASSERT(ret, cond) NDB_DBUS_ASSERT(ret, QDBusError::InternalError, cond, "%s: required symbol(s) not resolved", __func__)
 
-#define NDB_RESOLVE_SYMBOL(name, fn) resolveSymbol(libnickel, name, fn)
+// Resolves a libnickel symbol, and records whether it was found for ndbCapabilities()
+#define NDB_RESOLVE_SYMBOL(name, fn) nickelSymbols.insert(QStringLiteral(name), resolveSymbol(libnickel, name, fn))
+// As above, trying the symbol used by older firmware if the current one is missing.
+// Only the current name is recorded, as found if either one was.
+#define NDB_RESOLVE_SYMBOL_OR(name, fallback, fn) nickelSymbols.insert(QStringLiteral(name), \
+    resolveSymbol(libnickel, name, fn) || resolveSymbol(libnickel, fallback, fn))
 
 #ifdef DEBUG
 #define NDB_DEBUG(fmt, ...) nh_log("[debug] %s:%d:%s() " fmt, __FILE__, __LINE__, __func__, ##__VA_ARGS__)
@@ -40,8 +49,8 @@ namespace NDB {
 
 #define ARRAY_LEN(arr) (sizeof((arr)) / sizeof ((arr)[0]))
 
-void resolveSymbol(void* libnickel, const char *name, void **fn);
-void resolveSymbolRTLD(const char *name, void **fn);
+bool resolveSymbol(void* libnickel, const char *name, void **fn);
+bool resolveSymbolRTLD(const char *name, void **fn);
 
 } // namespace NDB
 